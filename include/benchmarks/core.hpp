@@ -1,6 +1,8 @@
 # pragma once
 
+# include <cstdint>
 # include <iostream>
+# include <stdexcept>
 # include <utility>
 # include <vector>
 
@@ -60,6 +62,119 @@ struct Coordinates{
 };
 
 
+/* classification of a grid cell, cells may have several types at once so
+ * the types are bit flags */
+enum CellType : uint8_t {
+    CELL_FREE       = 0,
+    CELL_WALL       = 1 << 0,
+    CELL_GOAL       = 1 << 1,
+    CELL_PIT        = 1 << 2,
+    CELL_TREASURE   = 1 << 3,
+    CELL_GOLD       = 1 << 4,
+    CELL_GEM        = 1 << 5,
+    CELL_ATTACKER   = 1 << 6
+};
+
+
+/* dense table of cell types of a height x width grid, built once a map is
+ * loaded, so that classifying a cell is a single array read instead of a
+ * lookup in a std::set of coordinates
+ *
+ * cells are stored row by row, cells outside of the grid are CELL_FREE
+ */
+class GridMap {
+
+    size_t height, width;
+    std::vector< uint8_t > cells;
+
+public:
+
+    GridMap() : height( 0 ), width( 0 ), cells() {  }
+
+    GridMap( size_t height, size_t width ) : height( height )
+                                           , width( width )
+                                           , cells( height * width, CELL_FREE ) {  }
+
+    bool in_bounds( const Coordinates &pos ) const {
+        return ( pos.x >= 0 ) && ( static_cast< size_t >( pos.x ) < width ) &&
+               ( pos.y >= 0 ) && ( static_cast< size_t >( pos.y ) < height );
+    }
+
+    // index of the cell in row-major order, pos has to be in bounds
+    size_t index( const Coordinates &pos ) const {
+        return pos.y * width + pos.x;
+    }
+
+    uint8_t get( const Coordinates &pos ) const {
+        return in_bounds( pos ) ? cells[ index( pos ) ] : static_cast< uint8_t >( CELL_FREE );
+    }
+
+    bool is( const Coordinates &pos, CellType type ) const {
+        return ( get( pos ) & type ) != 0;
+    }
+
+    // adds type to the cell, cells outside of the grid are ignored
+    void mark( const Coordinates &pos, CellType type ) {
+        if ( in_bounds( pos ) ) {
+            cells[ index( pos ) ] |= type;
+        }
+    }
+
+    template < typename container_t >
+    void mark_all( const container_t &positions, CellType type ) {
+        for ( const Coordinates &pos : positions ) {
+            mark( pos, type );
+        }
+    }
+
+    size_t size() const {
+        return cells.size();
+    }
+};
+
+
+/* state codecs map the states of a benchmark to dense integer ids
+ * 0 .. size() - 1 and back, so that tables over the states can be stored
+ * as flat arrays instead of ordered maps of structs ( e.g. the transition
+ * table of the racetrack )
+ *
+ * every codec provides state_t, size(), encode( state ) and decode( id ),
+ * encoding a state outside of the range of the codec throws
+ */
+
+// positions on a height x width grid, in row-major order
+class CoordinatesCodec {
+
+    size_t height, width;
+
+public:
+
+    using state_t = Coordinates;
+
+    CoordinatesCodec( size_t height, size_t width ) : height( height ), width( width ) {  }
+
+    size_t size() const {
+        return height * width;
+    }
+
+    bool contains( const Coordinates &pos ) const {
+        return ( pos.x >= 0 ) && ( static_cast< size_t >( pos.x ) < width ) &&
+               ( pos.y >= 0 ) && ( static_cast< size_t >( pos.y ) < height );
+    }
+
+    size_t encode( const Coordinates &pos ) const {
+        if ( !contains( pos ) ) {
+            throw std::runtime_error( "position outside of the encoded grid" );
+        }
+        return pos.y * width + pos.x;
+    }
+
+    Coordinates decode( size_t id ) const {
+        return Coordinates( static_cast< int >( id % width ), static_cast< int >( id / width ) );
+    }
+};
+
+
 inline Coordinates dir_to_vec( Direction dir ) {
     int dx = 0, dy = 0;
     switch ( dir ) {
@@ -9,7 +9,7 @@
 # include "benchmarks/core.hpp"
 # include "utils/prng.hpp"
 
-class FrozenLake : public Environment< Coordinates, Direction, std::vector< double > > {
+class FrozenLake final : public Environment< Coordinates, Direction, std::vector< double > > {
 
     double prob_of_slipping = 0.33;
 
@@ -21,6 +21,9 @@ class FrozenLake : public Environment< Coordinates, Direction, std::vector< doub
 
     PRNG gen;
     std::set< Coordinates > pits;
+
+    // pits as CELL_PIT, built from pits in the constructors
+    GridMap grid;
     Coordinates current_state, initial_state;
 
 
@@ -37,6 +40,9 @@ public:
     std::string name() const override;
     void set_hyperparams( double prob );
 
+    // dense ids of the positions on the lake
+    CoordinatesCodec state_codec() const;
+
     // constructors
     FrozenLake();
     FrozenLake( size_t height, size_t width, 
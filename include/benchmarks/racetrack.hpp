@@ -1,6 +1,9 @@
 # pragma once
 
 # include <algorithm>
+# include <array>
+# include <cstdint>
+# include <cstdlib>
 # include <fstream>
 # include <iostream>
 # include <set>
@@ -8,6 +11,7 @@
 # include "benchmarks/core.hpp"
 # include "models/environment.hpp"
 # include "utils/prng.hpp"
+# include "utils/serialization.hpp"
 
 
 /* stochastic shortest path benchmark adapted to multiple dimensions
@@ -64,13 +68,80 @@ struct VehicleState {
                    , velocity( ) {  }
 };
 
+
+// for checkpoints of the solvers, see utils/serialization.hpp
+template <>
+struct Serializer< VehicleState > {
+
+    static void write( BinaryWriter &out, const VehicleState &s ) {
+        out.write( s.position );
+        out.write( s.velocity );
+    }
+
+    static void read( BinaryReader &in, VehicleState &s ) {
+        in.read( s.position );
+        in.read( s.velocity );
+    }
+};
+
+// largest absolute value of each velocity component
+constexpr int max_velocity = 5;
+
+
+/* dense ids of racetrack states, ( position, velocity ) pairs are encoded as
+ * ( position * ( 2 * max_velocity + 1 ) + vx ) * ( 2 * max_velocity + 1 ) + vy,
+ * ( velocities shifted to be nonnegative ), the terminal state gets the last id */
+class VehicleCodec {
+
+    CoordinatesCodec positions;
+    VehicleState terminal_state;
+
+    static constexpr size_t velocities = 2 * max_velocity + 1;
+
+public:
+
+    using state_t = VehicleState;
+
+    VehicleCodec( size_t height, size_t width,
+                  const VehicleState &terminal ) : positions( height, width )
+                                                 , terminal_state( terminal ) {  }
+
+    size_t size() const {
+        return positions.size() * velocities * velocities + 1;
+    }
+
+    size_t encode( const VehicleState &s ) const {
+        if ( s == terminal_state ) {
+            return size() - 1;
+        }
+
+        auto [ vx, vy ] = s.velocity;
+        if ( ( std::abs( vx ) > max_velocity ) || ( std::abs( vy ) > max_velocity ) ) {
+            throw std::runtime_error( "velocity outside of the encoded range" );
+        }
+
+        return ( positions.encode( s.position ) * velocities + ( vx + max_velocity ) ) * velocities + ( vy + max_velocity );
+    }
+
+    VehicleState decode( size_t id ) const {
+        if ( id == size() - 1 ) {
+            return terminal_state;
+        }
+
+        int vy = static_cast< int >( id % velocities ) - max_velocity;
+        int vx = static_cast< int >( ( id / velocities ) % velocities ) - max_velocity;
+        return VehicleState( positions.decode( id / ( velocities * velocities ) ), { vx, vy } );
+    }
+};
+
+
 // for trace output during trajectory sampling
 inline std::ostream &operator<<( std::ostream& os, const std::pair< int, int > &velocity ) {
     os << velocity.first << "; " << velocity.second;
     return os;
 }
 
-class Racetrack : public Environment< VehicleState, std::pair< int, int >,  std::vector< double > > {
+class Racetrack final : public Environment< VehicleState, std::pair< int, int >,  std::vector< double > > {
 
     VehicleState current_state, initial_state;
 
@@ -79,13 +150,32 @@ class Racetrack : public Environment< VehicleState, std::pair< int, int >,  std:
 
     size_t height, width;
 
-    std::set< Coordinates > collision_states;
-    std::set< Coordinates > goal_states;
+    // walls ( CELL_WALL ) and the finish line ( CELL_GOAL )
+    GridMap grid;
+
     double slip_prob = 0.1;
     PRNG gen;
 
+    /* actions available for each velocity, indexed by velocity_index(), these
+     * do not depend on the track so they are built once in the constructor */
+    std::vector< std::vector< std::pair< int, int > > > action_lists;
+
+    /* optional precomputed transitions ( see precompute_transitions() ), for
+     * each state id of state_codec() and each of the nine velocity changes
+     * ( action_index() ) the ids of the successor without and with a slip
+     *
+     * the probabilities are given by slip_prob and the rewards only depend on
+     * the state, so neither has to be stored */
+    std::vector< std::array< uint32_t, 2 > > transition_table;
+
     bool vehicle_collides( const VehicleState& state ) const;
 
+    // successor of pos after changing its velocity by action, or the initial state on collision
+    VehicleState successor( const VehicleState &pos, const std::pair< int, int > &action ) const;
+
+    static size_t velocity_index( const std::pair< int, int > &velocity );
+    static size_t action_index( const std::pair< int, int > &action );
+
 public:
     using state_t  = Coordinates;
     using action_t = std::pair< int, int >;
@@ -105,7 +195,19 @@ public:
     std::pair< double, double > get_hyperparams() const;
 
     void set_hyperparams( double prob );
-    void from_file( const std::string &filename );
+
+    /* loads the track, if precompute is set the transition table of the
+     * track is built as well, see precompute_transitions() */
+    void from_file( const std::string &filename, bool precompute=false );
+
+    /* precomputes the successors of all ( state, action ) pairs of the loaded
+     * track, get_transition() then only reads the table */
+    void precompute_transitions();
+
+    bool has_transition_table() const;
+
+    // dense ids of the states of the loaded track
+    VehicleCodec state_codec() const;
 
     // constructors
     Racetrack();
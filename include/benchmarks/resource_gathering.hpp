@@ -37,7 +37,32 @@ struct ResourceState {
 };
 
 
-class ResourceGathering : public Environment< ResourceState, Direction, std::vector< double > > {
+// dense ids of resource states, position * 4 + gold + 2 * gems
+class ResourceCodec {
+
+    CoordinatesCodec positions;
+
+public:
+
+    using state_t = ResourceState;
+
+    ResourceCodec( size_t height, size_t width ) : positions( height, width ) {  }
+
+    size_t size() const {
+        return positions.size() * 4;
+    }
+
+    size_t encode( const ResourceState &s ) const {
+        return positions.encode( s.position ) * 4 + s.flags[0] + 2 * s.flags[1];
+    }
+
+    ResourceState decode( size_t id ) const {
+        return ResourceState( positions.decode( id / 4 ), { ( id & 1 ) != 0, ( id & 2 ) != 0 } );
+    }
+};
+
+
+class ResourceGathering final : public Environment< ResourceState, Direction, std::vector< double > > {
 
     double prob_of_attack = 0.0;
 
@@ -52,6 +77,9 @@ class ResourceGathering : public Environment< ResourceState, Direction, std::vec
     std::set< Coordinates > gems;
     std::set< Coordinates > attackers;
 
+    // gold, gems and attackers as CELL_GOLD, CELL_GEM and CELL_ATTACKER
+    GridMap grid;
+
     ResourceState current_state, initial_state;
 
 
@@ -67,6 +95,9 @@ public:
     std::string name() const override;
     void set_hyperparams( double prob );
 
+    // dense ids of the states of the grid
+    ResourceCodec state_codec() const;
+
     // constructors
     ResourceGathering();
     ResourceGathering( size_t height, size_t width, Coordinates initial_pos,
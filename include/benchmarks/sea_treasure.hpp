@@ -40,6 +40,45 @@ struct TreasureState {
 
 };
 
+/* dense ids of treasure states, position * 2 + treasure_collected, the
+ * terminal state gets the last id */
+class TreasureCodec {
+
+    CoordinatesCodec positions;
+    TreasureState terminal_state;
+
+public:
+
+    using state_t = TreasureState;
+
+    TreasureCodec( size_t height, size_t width,
+                   const TreasureState &terminal ) : positions( height, width )
+                                                   , terminal_state( terminal ) {  }
+
+    size_t size() const {
+        return positions.size() * 2 + 1;
+    }
+
+    size_t encode( const TreasureState &s ) const {
+        if ( s == terminal_state ) {
+            return size() - 1;
+        }
+        return positions.encode( s.position ) * 2 + s.treasure_collected;
+    }
+
+    TreasureState decode( size_t id ) const {
+        if ( id == size() - 1 ) {
+            return terminal_state;
+        }
+
+        TreasureState s;
+        s.position = positions.decode( id / 2 );
+        s.treasure_collected = ( id % 2 ) == 1;
+        return s;
+    }
+};
+
+
 inline std::ostream &operator<<( std::ostream& os, const Direction &dir ) {
     switch ( dir ) {
         case Direction::UP:
@@ -58,7 +97,7 @@ inline std::ostream &operator<<( std::ostream& os, const Direction &dir ) {
     return os;
 }
 
-class DeepSeaTreasure : public Environment< TreasureState, Direction, std::vector< double > > {
+class DeepSeaTreasure final : public Environment< TreasureState, Direction, std::vector< double > > {
 
     using reward_t = std::vector< double >;
 
@@ -76,7 +115,13 @@ class DeepSeaTreasure : public Environment< TreasureState, Direction, std::vecto
     // some squares may be inacessible like in the original benchmark 
     std::set< Coordinates > inacessible_squares;
 
+    /* treasures ( CELL_TREASURE ) and inaccessible squares ( CELL_WALL ), the
+     * value of a treasure is stored in treasure_values at its grid index */
+    GridMap grid;
+    std::vector< double > treasure_values;
+
     // helper functions
+    void build_grid();
     void initialize_state( Coordinates pos );
     bool terminated( const TreasureState& s );
 
@@ -98,6 +143,9 @@ public:
     std::set< Coordinates > get_inaccessible() const;
     std::pair< TreasureState, TreasureState > get_states() const;
 
+    // dense ids of the states of the loaded map
+    TreasureCodec state_codec() const;
+
     void set_hyperparams( double fuel, double noise_new );
     void from_file( const std::string &filename );
 
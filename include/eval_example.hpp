@@ -7,6 +7,7 @@
 #include "solvers/chvi.hpp"
 #include "solvers/config.hpp"
 
+#include "evaluation.hpp"
 #include "parser.hpp"
 
 #include <fstream>
@@ -69,5 +70,7 @@ void eval_example() {
     // runs SBPCA and SCHVI once on this benchmark, using the specified config
     // outputs curve & result data into out/results.csv
     // out/filename_curve-brtdp and out/filename_curve-chvi
-    run_benchmark( &uav5, config, 1 );
+    BenchmarkHarness harness( 1 );
+    harness.submit( uav5, config, 1 );
+    harness.collect();
 }
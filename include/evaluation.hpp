@@ -11,12 +11,20 @@
 #include "solvers/brtdp.hpp"
 #include "solvers/chvi.hpp"
 #include "solvers/config.hpp"
+#include "solvers/weighted_sum.hpp"
+
+#include "utils/thread_pool.hpp"
 
 #include "parser.hpp"
 
 #include <fstream>
+#include <future>
 #include <iostream>
+#include <memory>
+#include <optional>
+#include <set>
 #include <string>
+#include <type_traits>
 
 // helper struct for outputting to csv
 struct LogOutput {
@@ -76,35 +84,82 @@ void output_curve( const std::string &filename,
 
 
 
-// helper function for evaluation
-template < typename state_t, typename action_t, typename value_t >
-void run_benchmark( Environment< state_t, action_t, std::vector< value_t > >  *env,
-                    const ExplorationSettings< value_t > &config,
-                    size_t repeat=5 ){
+// largest distance of a vertex of one curve from the other curve
+template < typename value_t >
+value_t curve_distance( Polygon< value_t > lhs, Polygon< value_t > rhs ) {
+
+    // any point below both curves works for the closures
+    Point< value_t > ref_point( lhs.get_dimension(), 0 );
+    for ( const auto *curve : { &lhs, &rhs } ) {
+        for ( const auto &v : curve->get_vertices() ) {
+            for ( size_t i = 0; i < ref_point.size(); i++ ) {
+                ref_point[i] = std::min( ref_point[i], v[i] - 1 );
+            }
+        }
+    }
 
+    value_t dist = 0;
+    for ( auto [ from, to ] : { std::make_pair( &lhs, &rhs ), std::make_pair( &rhs, &lhs ) } ) {
+        to->init_facets();
+        to->downward_closure( ref_point );
+        for ( const auto &v : from->get_vertices() ) {
+            dist = std::max( dist, to->point_distance( v ) );
+        }
+    }
 
-    EnvironmentWrapper< state_t, action_t, std::vector< value_t >, value_t > envw( env );
-    EnvironmentWrapper< state_t, action_t, std::vector< value_t >, value_t > chvi_envw( env );
+    return dist;
+}
 
-    BRTDPSolver brtdp( std::move( envw ), config );
-    CHVIExactSolver chvi( std::move( chvi_envw ), config );
 
-    std::vector< VerificationResult< double > > brtdp_results;
-    std::vector< VerificationResult< double > > chvi_results;
+// appends a row of out/weighted_sum.csv and the curve of the weighted sum engine
+template < typename value_t >
+void write_weighted_sum( const ExplorationSettings< value_t > &config,
+                         const VerificationResult< value_t > &res_ws,
+                         const VerificationResult< value_t > &chvi_result ) {
 
-    for ( size_t i = 1; i <= repeat; i++ ) {
-        auto res_brtdp = brtdp.solve();
-        if ( !res_brtdp.converged ) {
-            std::cout << config.filename << " : BRTDP run " << i << " did not converge, continuing.\n";
-        }
-        auto res_chvi = chvi.solve();
-        if ( !res_chvi.converged ) {
-            std::cout << config.filename << " : CHVI run " << i << " did not converge, continuing.\n";
+    if ( !res_ws.converged ) {
+        std::cout << config.filename << " : weighted sum did not converge, continuing.\n";
+    }
+
+    std::ofstream out( "../out/weighted_sum.csv", std::fstream::app );
+    out << config.filename << ";" << res_ws.time_to_convergence << ";" << res_ws.update_number << ";";
+    out << res_ws.converged << ";" << curve_distance( res_ws.result_bound.lower(), chvi_result.result_bound.lower() ) << "\n";
+
+    output_curve( config.filename + "_ws", config, res_ws );
+}
+
+
+// mean time / calls of each profiled phase over repeated runs into out/profile.csv
+template < typename value_t >
+void write_profile( const std::string &filename,
+                    const std::string &solver,
+                    const std::vector< VerificationResult< value_t > > &results ) {
+
+    if ( results.empty() ) { return; }
+
+    std::ofstream out( "../out/profile.csv", std::fstream::app );
+    double res_size = static_cast< double >( results.size() );
+
+    for ( size_t i = 0; i < num_profile_phases; i++ ) {
+        ProfilePhase phase = static_cast< ProfilePhase >( i );
+        double seconds_mean = 0, calls_mean = 0;
+
+        for ( const auto &res : results ) {
+            seconds_mean += res.profile[ phase ].seconds / res_size;
+            calls_mean += static_cast< double >( res.profile[ phase ].calls ) / res_size;
         }
 
-        brtdp_results.emplace_back( std::move( res_brtdp ) );
-        chvi_results.emplace_back( std::move( res_chvi ) );
+        out << filename << ";" << solver << ";" << phase_name( phase ) << ";" << seconds_mean << ";" << calls_mean << "\n";
     }
+}
+
+
+// outputs aggregated results of repeated runs of both solvers on one benchmark
+template < typename value_t >
+void write_benchmark_results( const ExplorationSettings< value_t > &config,
+                              const std::vector< VerificationResult< value_t > > &brtdp_results,
+                              const std::vector< VerificationResult< value_t > > &chvi_results,
+                              size_t threads ) {
 
     LogOutput brtdp_logs = aggregate_results( brtdp_results );
     LogOutput chvi_logs = aggregate_results( chvi_results );
@@ -115,25 +170,156 @@ void run_benchmark( Environment< state_t, action_t, std::vector< value_t > >  *e
 
     out << config.filename << ";" << chvi_logs.explored_mean << ";" << brtdp_logs.time_mean << ";" << brtdp_logs.time_std << ";";
     out << brtdp_logs.updates_mean << ";" << brtdp_logs.updates_std << ";";
-    out << chvi_logs.time_mean << ";" << chvi_logs.time_std << ";" << chvi_logs.updates_mean << "\n";
+    out << chvi_logs.time_mean << ";" << chvi_logs.time_std << ";" << chvi_logs.updates_mean << ";";
+    // times of concurrent runs are affected by contention
+    out << threads << "\n";
     expl << config.filename << ";" << chvi_logs.explored_mean << ";";
     expl << brtdp_logs.explored_mean << ";" << brtdp_logs.explored_std << ";";
     expl << brtdp_logs.didnt_converge << ";" << chvi_logs.didnt_converge << "\n";
 
-    for ( size_t i = 0; i < repeat; i++ ) {
+    if constexpr ( profiling_enabled ) {
+        write_profile( config.filename, "brtdp", brtdp_results );
+        write_profile( config.filename, "chvi", chvi_results );
+    }
+
+    for ( size_t i = 0; i < brtdp_results.size(); i++ ) {
         output_curve( config.filename + "_brtdp", config, brtdp_results[i] );
         output_curve( config.filename + "_chvi", config, chvi_results[i] );
 
     }
-        
 
     out.close();
     expl.close();
 }
 
 
+/* runs the benchmarks, each ( benchmark, solver, heuristic, repeat ) is
+ * scheduled as an independent task on a thread pool, with its own copy of the
+ * environment and its own wrapper, the solvers reseed the copies by reset()
+ * from the seed of the repeat
+ *
+ * sparse MDPs are also solved by the weighted sum engine, once per benchmark
+ * name, its result does not depend on the heuristic
+ *
+ * collect() waits for all submitted tasks and writes the results in the
+ * order of submission. the measured times of concurrent runs are affected by
+ * contention, hence a single thread is used unless requested otherwise, the
+ * number of threads is recorded in results.csv.
+ */
+class BenchmarkHarness {
+
+    using result_t = VerificationResult< double >;
+
+    struct PendingBenchmark {
+        ExplorationSettings< double > config;
+        std::vector< std::future< result_t > > brtdp, chvi;
+        std::optional< std::future< result_t > > weighted_sum;
+    };
+
+    ThreadPool pool;
+    std::vector< PendingBenchmark > pending;
+
+    // benchmarks already solved by the weighted sum engine
+    std::set< std::string > weighted_sum_submitted;
+
+    // collects results of one solver, reporting runs that did not converge
+    static std::vector< result_t > get_results( std::vector< std::future< result_t > > &futures,
+                                                const std::string &name,
+                                                const std::string &solver ) {
+        std::vector< result_t > results;
+        for ( size_t i = 0; i < futures.size(); i++ ) {
+            results.emplace_back( futures[i].get() );
+            if ( !results.back().converged ) {
+                std::cout << name << " : " << solver << " run " << i + 1 << " did not converge, continuing.\n";
+            }
+        }
+        return results;
+    }
+
+public:
 
-void eval_uav( double tau, ActionSelectionHeuristic heuristic ){
+    // 0 threads -> one per hardware thread
+    explicit BenchmarkHarness( size_t threads = 1 ) : pool( threads ) {  }
+
+    size_t num_threads() const {
+        return pool.size();
+    }
+
+    template < typename env_t >
+    void submit( const env_t &env, const ExplorationSettings< double > &config, size_t repeat=5 ) {
+
+        using state_t = environment_state_t< env_t >;
+        using action_t = environment_action_t< env_t >;
+        // calls are dispatched statically to env_t, see EnvironmentWrapper
+        using wrapper_t = EnvironmentWrapper< state_t, action_t, std::vector< double >, double, env_t >;
+
+        // shared read-only prototype, copied by each task
+        auto prototype = std::make_shared< const env_t >( env );
+
+        PendingBenchmark benchmark{ config, {}, {}, std::nullopt };
+
+        for ( size_t i = 0; i < repeat; i++ ) {
+
+            // each repeat gets its own seed, derived from the master seed
+            ExplorationSettings< double > run_config = config;
+            run_config.seed = derive_seed( config.seed, SeedStream::Run, i );
+
+            // concurrent runs must not replace each other's checkpoints
+            auto solver_config = [ & ]( const std::string &solver ) {
+                ExplorationSettings< double > res = run_config;
+                res.checkpoint_file += "." + config.filename + "-" + solver + "-" + std::to_string( i );
+                return res;
+            };
+
+            benchmark.brtdp.emplace_back( pool.submit( [ prototype, config = solver_config( "brtdp" ) ]{
+                env_t local( *prototype );
+                BRTDPSolver< state_t, action_t, double, env_t > brtdp( wrapper_t( &local ), config );
+                return brtdp.solve();
+            }));
+
+            benchmark.chvi.emplace_back( pool.submit( [ prototype, config = solver_config( "chvi" ) ]{
+                env_t local( *prototype );
+                CHVIExactSolver< state_t, action_t, double, env_t > chvi( wrapper_t( &local ), config );
+                return chvi.solve();
+            }));
+        }
+
+        if constexpr ( std::is_base_of_v< MDP< double >, env_t > ) {
+            // the other heuristics would solve the same MDP again
+            if ( weighted_sum_submitted.insert( config.filename ).second ) {
+                benchmark.weighted_sum = pool.submit( [ prototype, config ]{
+                    env_t local( *prototype );
+                    WeightedSumSolver< double > ws( local, config );
+                    return ws.solve();
+                });
+            }
+        }
+
+        pending.emplace_back( std::move( benchmark ) );
+    }
+
+    // waits for all submitted benchmarks and outputs their results
+    void collect() {
+        for ( auto &benchmark : pending ) {
+            const auto &config = benchmark.config;
+
+            auto brtdp_results = get_results( benchmark.brtdp, config.filename, "BRTDP" );
+            auto chvi_results = get_results( benchmark.chvi, config.filename, "CHVI" );
+
+            write_benchmark_results( config, brtdp_results, chvi_results, num_threads() );
+
+            if ( benchmark.weighted_sum && !chvi_results.empty() ) {
+                write_weighted_sum( config, benchmark.weighted_sum->get(), chvi_results.back() );
+            }
+        }
+
+        pending.clear();
+    }
+};
+
+
+
+void eval_uav( double tau, ActionSelectionHeuristic heuristic, BenchmarkHarness &harness ){
 
     PrismParser parser;
 
@@ -185,23 +371,23 @@ void eval_uav( double tau, ActionSelectionHeuristic heuristic ){
     config.directions = { OptimizationDirection::MINIMIZE, OptimizationDirection::MINIMIZE };
 
     config.filename = "uav5";
-    run_benchmark( &uav5, config );
+    harness.submit( uav5, config );
 
     config.directions = { OptimizationDirection::MAXIMIZE, OptimizationDirection::MAXIMIZE };
 
     config.filename = "teamform3";
-    run_benchmark( &teamform3, config );
+    harness.submit( teamform3, config );
 
     config.directions = { OptimizationDirection::MINIMIZE, OptimizationDirection::MINIMIZE };
 
     config.filename = "pareto_taskgraph5";
-    run_benchmark( &ptaskgraph5, config );
+    harness.submit( ptaskgraph5, config );
 
     config.filename = "taskgraph30";
-    run_benchmark( &taskgraph30, config );
+    harness.submit( taskgraph30, config );
 }
 
-void eval_racetrack( double tau, ActionSelectionHeuristic heuristic ){
+void eval_racetrack( double tau, ActionSelectionHeuristic heuristic, BenchmarkHarness &harness ){
     
     ExplorationSettings< double > config;
 
@@ -219,20 +405,24 @@ void eval_racetrack( double tau, ActionSelectionHeuristic heuristic ){
     Racetrack easy;
     config.filename = "racetrack-easy";
     config.trace = false;
-    easy.from_file("../benchmarks/racetracks/racetrack-easy.track");
-    run_benchmark( &easy, config );
+    easy.from_file("../benchmarks/racetracks/racetrack-easy.track", true);
+    harness.submit( easy, config );
 
     config.filename = "racetrack-ring";
-    easy.from_file("../benchmarks/racetracks/racetrack-ring.track");
-    run_benchmark( &easy, config );
+    easy.from_file("../benchmarks/racetracks/racetrack-ring.track", true);
+    harness.submit( easy, config );
 
     config.filename = "racetrack-hard";
-    easy.from_file("../benchmarks/racetracks/racetrack-hard.track");
-    run_benchmark( &easy, config );
+    easy.from_file("../benchmarks/racetracks/racetrack-hard.track", true);
+    harness.submit( easy, config );
+
+    config.filename = "racetrack-barto-big";
+    easy.from_file("../benchmarks/racetracks/barto-big.track", true);
+    harness.submit( easy, config );
 }
 
 
-void eval_treasure( double tau, ActionSelectionHeuristic heuristic ){
+void eval_treasure( double tau, ActionSelectionHeuristic heuristic, BenchmarkHarness &harness ){
 
     ExplorationSettings< double > config;
     config.action_heuristic = heuristic;
@@ -251,12 +441,12 @@ void eval_treasure( double tau, ActionSelectionHeuristic heuristic ){
     dst_convex.from_file( "../benchmarks/treasures/treasure-convex.txt" );
 
     config.filename = "treasure-concave";
-    run_benchmark( &dst, config );
+    harness.submit( dst, config );
     config.filename = "treasure-convex";
-    run_benchmark( &dst_convex, config );
+    harness.submit( dst_convex, config );
 }
 
-void eval_frozenlake( double tau, ActionSelectionHeuristic heuristic ){
+void eval_frozenlake( double tau, ActionSelectionHeuristic heuristic, BenchmarkHarness &harness ){
     ExplorationSettings< double > config;
     config.action_heuristic = heuristic;
     config.max_depth = 0;
@@ -271,7 +461,7 @@ void eval_frozenlake( double tau, ActionSelectionHeuristic heuristic ){
 
     FrozenLake lake;
 
-    run_benchmark( &lake, config );
+    harness.submit( lake, config );
 
     FrozenLake lake2( 15, 15, {
                        Coordinates(1, 5),
@@ -289,13 +479,13 @@ void eval_frozenlake( double tau, ActionSelectionHeuristic heuristic ){
                        Coordinates(13, 7),
             }, 0.33 );
     config.filename = "lake-hard";
-    run_benchmark( &lake2, config );
+    harness.submit( lake2, config );
 }
 
-void eval_benchmarks( double tau, ActionSelectionHeuristic heuristic ) {
-    eval_uav( tau , heuristic );
-    eval_treasure( tau, heuristic );
-    eval_frozenlake( tau, heuristic );
-    eval_racetrack( tau , heuristic );
+void eval_benchmarks( double tau, ActionSelectionHeuristic heuristic, BenchmarkHarness &harness ) {
+    eval_uav( tau , heuristic, harness );
+    eval_treasure( tau, heuristic, harness );
+    eval_frozenlake( tau, heuristic, harness );
+    eval_racetrack( tau , heuristic, harness );
 }
 
@@ -45,7 +45,7 @@ std::vector< double > FrozenLake::get_reward( const Coordinates &pos, const Dire
             rewards[0] += prob;
         }
 
-        else if ( pits.find( succ ) != pits.end() ) {
+        else if ( grid.is( succ, CELL_PIT ) ) {
             // negative rew for pits
             rewards[1] += prob;
         }
@@ -98,6 +98,10 @@ std::string FrozenLake::name() const {
     return "FrozenLake " + dimensions + " " + std::to_string( prob_of_slipping );
 }
 
+CoordinatesCodec FrozenLake::state_codec() const {
+    return CoordinatesCodec( height, width );
+}
+
 void FrozenLake::set_hyperparams( double prob ) {
     prob_of_slipping = prob;
 }
@@ -111,12 +115,14 @@ FrozenLake::FrozenLake() :
                                  , Coordinates( 1, 3 )
                                  , Coordinates( 3, 3 )
                                  , Coordinates( 5, 7 ) } )
+                         , grid( 9, 9 )
                          , current_state( 0, 0 )
                          , initial_state( 0, 0 )
 {
     /* initalizes to sample benchmark from tutorial
      * https://gymnasium.farama.org/tutorials/training_agents/FrozenLake_tuto
      */
+    grid.mark_all( pits, CELL_PIT );
 }
 FrozenLake::FrozenLake( size_t height
                       , size_t width
@@ -126,8 +132,9 @@ FrozenLake::FrozenLake( size_t height
                                                   , height( height )
                                                   , width( width )
                                                   , pits( pits )
+                                                  , grid( height, width )
                                                   , current_state( 0, 0 )
                                                   , initial_state( 0, 0 )
 {
-
+    grid.mark_all( pits, CELL_PIT );
 }
@@ -1,8 +1,10 @@
 # pragma once 
 
 # include <algorithm> 
+# include <cstdint>
 # include <iostream>
 # include <fstream>
+# include <limits>
 # include <sstream>
 # include <string>
 
@@ -87,6 +89,25 @@ public:
         return vertices[i];
     }
 
+    // heap memory held by the vertices and facets, in bytes ( capacities )
+    size_t memory_bytes() const {
+        size_t bytes = vertices.capacity() * sizeof( Point< value_t > )
+                     + facets.capacity() * sizeof( Facet );
+
+        for ( const auto &v : vertices ) {
+            bytes += v.capacity() * sizeof( value_t );
+        }
+
+        for ( const auto &f : facets ) {
+            bytes += f.points.capacity() * sizeof( Point< value_t > );
+            for ( const auto &v : f.points ) {
+                bytes += v.capacity() * sizeof( value_t );
+            }
+        }
+
+        return bytes;
+    }
+
     /* helper methods for shifting vertices by scalar / vector values
      * work in place, i.e. modify *this polygon */
     void multiply_scalar( value_t mult ) {
@@ -169,6 +190,24 @@ public:
 
 
 
+    // same number of vertices, all coordinates equal up to eps
+    bool equals( const Polygon& other, value_t eps ) const {
+
+        const auto &other_vertices = other.get_vertices();
+        if ( vertices.size() != other_vertices.size() ) { return false; }
+
+        for ( size_t i = 0; i < vertices.size(); i++ ) {
+            if ( vertices[i].size() != other_vertices[i].size() ) { return false; }
+
+            for ( size_t j = 0; j < vertices[i].size(); j++ ) {
+                if ( std::abs( vertices[i][j] - other_vertices[i][j] ) > eps ) { return false; }
+            }
+        }
+
+        return true;
+    }
+
+
     /*
      * closure & distance methods
      * preconditions:
@@ -220,6 +259,217 @@ public:
         facets.push_back( Facet({ facet_y, max_y_point }) );
     }
 
+    /* checks whether point lies in the downward closure of this curve, i.e.
+     * whether some point on the curve weakly dominates it
+     * ( same preconditions as above, facets are not needed )
+     */
+    bool dominates( const Point< value_t >& point ) const {
+
+        if ( vertices.empty() )
+            return false;
+
+        if ( get_dimension() == 1 ) {
+            return point[0] <= vertices[0][0];
+        }
+
+        // right of the whole curve
+        if ( point[0] > vertices[0][0] ) { return false; }
+
+        // left of the whole curve, compare with the largest y value
+        if ( point[0] <= vertices.back()[0] ) { return point[1] <= vertices.back()[1]; }
+
+        // find first vertex with x <= point[0], the curve is sorted descending
+        auto it = std::lower_bound( vertices.begin(), vertices.end(), point,
+                                    []( const auto &v, const auto &pt ){ return v[0] > pt[0]; } );
+
+        if ( it == vertices.begin() ) { return point[1] <= vertices[0][1]; }
+
+        const Point< value_t > &right = *( it - 1 ), &left = *it;
+
+        // y coordinate of the segment [ right, left ] at point[0]
+        value_t coeff = ( right[0] - point[0] ) / ( right[0] - left[0] );
+        value_t y = right[1] + coeff * ( left[1] - right[1] );
+
+        return point[1] <= y;
+    }
+
+    // whether every vertex of other lies in the downward closure of this curve
+    bool dominates( const Polygon& other ) const {
+        for ( const auto &v : other.get_vertices() ) {
+            if ( !dominates( v ) ) { return false; }
+        }
+        return true;
+    }
+
+    /* smallest t >= 0 such that point - ( t, .., t ) lies in the downward
+     * closure of this curve, i.e. the largest violation of the inequalities
+     * describing the closure ( x <= max x, y <= max y and one per edge ),
+     * each divided by the sum of the coefficients of its normal, O( n ) */
+    value_t dominance_gap( const Point< value_t >& point ) const {
+
+        if ( vertices.empty() )
+            return std::numeric_limits< value_t >::infinity();
+
+        if ( get_dimension() == 1 ) {
+            return std::max< value_t >( 0, point[0] - vertices[0][0] );
+        }
+
+        value_t gap = std::max< value_t >( { 0, point[0] - vertices[0][0], point[1] - vertices.back()[1] } );
+
+        for ( size_t i = 0; i + 1 < vertices.size(); i++ ) {
+
+            // normal ( dy, -dx ) of the edge, both components nonnegative
+            value_t nx = vertices[ i + 1 ][1] - vertices[i][1];
+            value_t ny = vertices[i][0] - vertices[ i + 1 ][0];
+            if ( nx + ny <= 0 ) { continue; }
+
+            value_t violation = nx * ( point[0] - vertices[i][0] ) + ny * ( point[1] - vertices[i][1] );
+            gap = std::max( gap, violation / ( nx + ny ) );
+        }
+
+        return gap;
+    }
+
+    /*
+     * queries over the curve, O( log n ) by binary search on the edges
+     * ( same preconditions as above, facets are not needed )
+     *
+     * along the curve the edges turn clockwise, ( dy / -dx ) decreases, so
+     * the weighted sum of the vertices is unimodal for weights with a
+     * nonnegative second component
+     */
+
+    // index of a vertex maximizing the weighted sum of objectives
+    size_t support_index( const std::vector< value_t > &weights ) const {
+
+        if ( vertices.size() < 2 ) { return 0; }
+
+        // the weighted sum is convex along the curve, one of the ends is maximal
+        if ( weights[1] < 0 ) {
+            return ( dot_product( weights, vertices[0] ) >= dot_product( weights, vertices.back() ) ) ? 0 : vertices.size() - 1;
+        }
+
+        // first vertex whose outgoing edge does not increase the weighted sum
+        auto increases = [ & ]( size_t i ){
+            return weights[0] * ( vertices[ i + 1 ][0] - vertices[i][0] )
+                 + weights[1] * ( vertices[ i + 1 ][1] - vertices[i][1] ) > 0;
+        };
+
+        size_t lo = 0, hi = vertices.size() - 1;
+        while ( lo < hi ) {
+            size_t mid = lo + ( hi - lo ) / 2;
+            if ( increases( mid ) ) { lo = mid + 1; }
+            else                    { hi = mid; }
+        }
+
+        return lo;
+    }
+
+    // support function, the largest weighted sum of objectives over the curve
+    value_t support( const std::vector< value_t > &weights ) const {
+        if ( vertices.empty() ) {
+            throw std::runtime_error( "support of an empty pareto curve" );
+        }
+        return dot_product( weights, vertices[ support_index( weights ) ] );
+    }
+
+    // vertex achieving the support value
+    const Point< value_t > &weighted_optimum( const std::vector< value_t > &weights ) const {
+        if ( vertices.empty() ) {
+            throw std::runtime_error( "support of an empty pareto curve" );
+        }
+        return vertices[ support_index( weights ) ];
+    }
+
+    /* support_index() of many weight vectors, the slopes of the edges are
+     * computed once, each query is then a binary search over them */
+    std::vector< size_t > support_indices( const std::vector< std::vector< value_t > > &weights ) const {
+
+        std::vector< size_t > res( weights.size(), 0 );
+        if ( vertices.size() < 2 ) { return res; }
+
+        // dy / -dx of each edge, decreasing along the curve
+        std::vector< value_t > slopes( vertices.size() - 1 );
+        for ( size_t i = 0; i + 1 < vertices.size(); i++ ) {
+            slopes[i] = ( vertices[ i + 1 ][1] - vertices[i][1] ) / ( vertices[i][0] - vertices[ i + 1 ][0] );
+        }
+
+        for ( size_t q = 0; q < weights.size(); q++ ) {
+            const auto &w = weights[q];
+
+            if ( w[1] <= 0 ) {
+                res[q] = support_index( w );
+                continue;
+            }
+
+            // edge i increases the weighted sum iff w[1] * slope > w[0]
+            value_t threshold = w[0] / w[1];
+            res[q] = std::partition_point( slopes.begin(), slopes.end(),
+                                           [ threshold ]( value_t slope ){ return slope > threshold; } ) - slopes.begin();
+        }
+
+        return res;
+    }
+
+    // support() of many weight vectors
+    std::vector< value_t > supports( const std::vector< std::vector< value_t > > &weights ) const {
+        std::vector< size_t > indices = support_indices( weights );
+
+        std::vector< value_t > res( weights.size() );
+        for ( size_t q = 0; q < weights.size(); q++ ) {
+            res[q] = dot_product( weights[q], vertices[ indices[q] ] );
+        }
+
+        return res;
+    }
+
+    /* closest point ( euclidean ) to target in the downward closure of the
+     * curve, i.e. target itself if it is achievable, otherwise its
+     * projection on the curve or on the two rays closing it */
+    Point< value_t > closest_achievable( const Point< value_t > &target ) const {
+
+        if ( vertices.empty() ) {
+            throw std::runtime_error( "projection on an empty pareto curve" );
+        }
+
+        if ( dominates( target ) ) { return target; }
+
+        if ( get_dimension() == 1 ) { return vertices[0]; }
+
+        const Point< value_t > &first = vertices[0], &last = vertices.back();
+
+        // below the largest x coordinate, or left of the largest y coordinate
+        if ( ( target[0] >= first[0] ) && ( target[1] <= first[1] ) ) { return { first[0], target[1] }; }
+        if ( ( target[1] >= last[1] ) && ( target[0] <= last[0] ) ) { return { target[0], last[1] }; }
+
+        // first edge the projection of target does not pass the end of
+        auto passes = [ & ]( size_t i ){
+            return ( target[0] - vertices[ i + 1 ][0] ) * ( vertices[ i + 1 ][0] - vertices[i][0] )
+                 + ( target[1] - vertices[ i + 1 ][1] ) * ( vertices[ i + 1 ][1] - vertices[i][1] ) > 0;
+        };
+
+        size_t lo = 0, hi = vertices.size() - 1;
+        while ( lo < hi ) {
+            size_t mid = lo + ( hi - lo ) / 2;
+            if ( passes( mid ) ) { lo = mid + 1; }
+            else                 { hi = mid; }
+        }
+
+        if ( lo == vertices.size() - 1 ) { return last; }
+
+        // projection on the edge [ v_lo, v_lo+1 ]
+        Point< value_t > edge( vertices[ lo + 1 ] ), delta( target );
+        subtract( edge, vertices[ lo ] );
+        subtract( delta, vertices[ lo ] );
+
+        value_t coeff = std::clamp( dot_product( delta, edge ) / dot_product( edge, edge ), value_t( 0 ), value_t( 1 ) );
+
+        Point< value_t > res( vertices[ lo ] );
+        multiply( coeff, edge );
+        add( res, edge );
+        return res;
+    }
+
     /* precondition -> init_facets() and downward_closure() called beforehand
      */
     value_t point_distance( const Point< value_t >& point ) const {
@@ -338,9 +588,12 @@ std::vector< Point< value_t > > upper_right_hull( std::vector< Point< value_t >
 
 
 
+/* if origins is given, it is filled with ( curve index, vertex index ) of
+ * every vertex of the result, i.e. which curve produced it */
 template< typename value_t > 
 Polygon< value_t > hull_union( std::vector< Polygon< value_t > * > curves,
-                 double eps ){
+                 double eps,
+                 std::vector< std::pair< uint32_t, uint32_t > > *origins=nullptr ){
     std::vector< Point< value_t > > vertices;
     for ( auto ptr : curves ){
         auto& curve_vrt = ptr->get_vertices();
@@ -348,6 +601,24 @@ Polygon< value_t > hull_union( std::vector< Polygon< value_t > * > curves,
     }
 
     std::vector< Point< value_t > > hull_vertices = upper_right_hull( vertices, eps );
+
+    if ( origins != nullptr ) {
+        origins->clear();
+
+        // the hull consists of copies of the input vertices
+        for ( const auto &v : hull_vertices ) {
+            bool found = false;
+            for ( uint32_t i = 0; ( i < curves.size() ) && !found; i++ ) {
+                const auto &curve_vrt = curves[i]->get_vertices();
+                auto it = std::find( curve_vrt.begin(), curve_vrt.end(), v );
+                if ( it != curve_vrt.end() ) {
+                    origins->emplace_back( i, static_cast< uint32_t >( it - curve_vrt.begin() ) );
+                    found = true;
+                }
+            }
+        }
+    }
+
     Polygon< value_t > result( hull_vertices );
     return result;
 }
@@ -372,10 +643,14 @@ Polygon< value_t > naive_minkowski_sum( const std::vector< Polygon< value_t > *
  *
  * Functions used for state-action bound updates
  *
+ * if origins is given, it is filled with the indices of the summed vertices
+ * of every vertex of the result, args.size() entries per vertex
+ *
  */
 template < typename value_t >
 Polygon< value_t > weighted_minkowski_sum( const std::vector< Polygon< value_t > * > &args,
-                             const std::vector< double > &probs ) {
+                             const std::vector< double > &probs,
+                             std::vector< uint32_t > *origins=nullptr ) {
     if ( args.empty() ){
         throw std::runtime_error("empty curve operation - minkowski sum");
     }
@@ -385,7 +660,11 @@ Polygon< value_t > weighted_minkowski_sum( const std::vector< Polygon< value_t >
     }
 
     if ( args[0]->get_dimension() == 2 ){
-        return multiple_minkowski_sum( args, probs );
+        return multiple_minkowski_sum( args, probs, origins );
+    }
+
+    if ( origins != nullptr ) {
+        origins->assign( args.size(), 0 );
     }
 
     // else 1d
@@ -409,9 +688,11 @@ Polygon< value_t > weighted_minkowski_sum( const std::vector< Polygon< value_t >
  */
 template< typename value_t >
 Polygon< value_t > multiple_minkowski_sum( const std::vector< Polygon< value_t > * > &curves,
-                                           const std::vector< double > &probs ){
+                                           const std::vector< double > &probs,
+                                           std::vector< uint32_t > *origins=nullptr ){
 
     std::vector< Point< value_t > > resulting_vertices;
+    if ( origins != nullptr ) { origins->clear(); }
 
     // indices into vertex array of each polygon 
     std::vector< size_t > offsets( curves.size(), 0 );
@@ -452,6 +733,11 @@ Polygon< value_t > multiple_minkowski_sum( const std::vector< Polygon< value_t >
 
         resulting_vertices.push_back( next );
 
+        // the vertex is the sum of the current vertex of each curve
+        if ( origins != nullptr ) {
+            std::copy( offsets.begin(), offsets.end(), std::back_inserter( *origins ) );
+        }
+
         // track all edges with minimal polar angle, to remove colinear
         // points
         std::vector< size_t > incremented_indices = {};
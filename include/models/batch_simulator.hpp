@@ -0,0 +1,308 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <future>
+#include <map>
+#include <vector>
+#include "models/environment.hpp"
+#include "utils/prng.hpp"
+#include "utils/thread_pool.hpp"
+
+/*
+ * batched simulation of an environment, K independent runs ( lanes ) are
+ * stepped in lockstep under a given policy, e.g. to evaluate many rollouts of
+ * a scheduler, or to measure the simulation throughput of a benchmark
+ *
+ * the lanes are kept as separate arrays indexed by the lane ( states,
+ * returns, step counts, generators, ... ), the environment itself is only
+ * queried for transitions and rewards of the lane states, so one copy of it
+ * per thread suffices ( copies of large models are expensive )
+ *
+ * the lanes are split into contiguous blocks simulated in parallel, one
+ * block per thread, each lane samples its actions and successors from its
+ * own generator, split from a generator seeded by the Solver stream of the
+ * seed, so runs with the same nonzero seed are reproducible regardless of
+ * the number of threads
+ *
+ * a lane stops at the horizon or once it reaches an absorbing state ( a
+ * single enabled action, which loops with probability 1 and zero reward )
+ *
+ * env_t is the concrete environment type, so that the calls are resolved at
+ * compile time, see EnvironmentWrapper
+ */
+
+
+/* policies simulated by BatchSimulator have to provide
+ *
+ *  void reset( size_t lane, const state_t &initial )
+ *      called once per lane before the first step
+ *
+ *  action_t act( size_t lane, const env_t &env, const state_t &state, PRNG &gen )
+ *      action played in state, gen is the generator of the lane
+ *
+ *  void observe( size_t lane, const state_t &state, const action_t &action,
+ *                const reward_t &reward, const state_t &next )
+ *      called after each step of the lane
+ *
+ * calls for different lanes may run concurrently, so per-lane memory of a
+ * policy has to be indexed by the lane
+ */
+
+// plays an enabled action uniformly at random, memoryless
+template < typename env_t >
+struct UniformPolicy {
+
+    using state_t = environment_state_t< env_t >;
+    using action_t = environment_action_t< env_t >;
+    using reward_t = environment_reward_t< env_t >;
+
+    void reset( size_t, const state_t & ) {  }
+
+    action_t act( size_t, const env_t &env, const state_t &state, PRNG &gen ) const {
+        return gen.sample_uniformly( env.get_actions( state ) );
+    }
+
+    void observe( size_t, const state_t &, const action_t &, const reward_t &, const state_t & ) {  }
+};
+
+
+struct BatchSettings {
+
+    // number of independent runs
+    size_t lanes = 1024;
+
+    // maximum number of steps of each lane, lanes also stop in absorbing states
+    size_t horizon = 100;
+
+    // rewards of step t are multiplied by discount^t
+    double discount = 1.0;
+
+    // 0 threads -> one per hardware thread
+    size_t threads = 0;
+
+    // 0 -> random seed
+    unsigned seed = 0;
+};
+
+
+struct BatchResult {
+
+    size_t lanes = 0;
+    size_t objectives = 0;
+
+    // total steps of all lanes and the wall-clock time of the simulation
+    size_t steps = 0;
+    double seconds = 0;
+
+    // discounted return of each lane, lane-major ( lanes x objectives )
+    std::vector< double > returns;
+
+    // steps of each lane, and whether the lane ended in an absorbing state
+    std::vector< size_t > lane_steps;
+    std::vector< uint8_t > terminated;
+
+    double steps_per_second() const {
+        return ( seconds > 0 ) ? steps / seconds : 0;
+    }
+
+    double get_return( size_t lane, size_t objective ) const {
+        return returns[ lane * objectives + objective ];
+    }
+
+    double mean_return( size_t objective ) const {
+        double sum = 0;
+        for ( size_t lane = 0; lane < lanes; lane++ ) {
+            sum += get_return( lane, objective );
+        }
+        return ( lanes > 0 ) ? sum / lanes : 0;
+    }
+
+    // sample standard deviation of the returns
+    double std_return( size_t objective ) const {
+        if ( lanes < 2 ) { return 0; }
+
+        double mean = mean_return( objective ), sum = 0;
+        for ( size_t lane = 0; lane < lanes; lane++ ) {
+            sum += std::pow( get_return( lane, objective ) - mean, 2 );
+        }
+        return std::sqrt( sum / ( lanes - 1 ) );
+    }
+};
+
+
+template < typename env_t >
+class BatchSimulator {
+
+    using state_t = environment_state_t< env_t >;
+    using action_t = environment_action_t< env_t >;
+    using reward_t = environment_reward_t< env_t >;
+
+    BatchSettings settings;
+    ThreadPool pool;
+
+    // one copy of the environment per block, and the initial state
+    std::vector< env_t > envs;
+    state_t initial_state;
+
+    // per-lane data
+    std::vector< state_t > states;
+    std::vector< PRNG > gens;
+    std::vector< double > discounts;
+    std::vector< double > returns;
+    std::vector< size_t > steps;
+    std::vector< uint8_t > done;
+
+    size_t objectives;
+
+    size_t block_size() const {
+        size_t blocks = std::max< size_t >( 1, std::min( pool.size(), settings.lanes ) );
+        return std::max< size_t >( 1, ( settings.lanes + blocks - 1 ) / blocks );
+    }
+
+    bool absorbing( env_t &env, const state_t &state, const action_t &action,
+                    const std::map< state_t, double > &transition, const reward_t &reward ) const {
+
+        // states are only required to be ordered, see std::map
+        const state_t &succ = transition.begin()->first;
+        if ( ( transition.size() != 1 ) || ( succ < state ) || ( state < succ ) ) { return false; }
+
+        for ( size_t i = 0; i < objectives; i++ ) {
+            if ( reward[i] != 0 ) { return false; }
+        }
+
+        auto actions = env.get_actions( state );
+        return ( actions.size() == 1 ) && ( actions[0] == action );
+    }
+
+    // simulates lanes [ first, last ) until the horizon, returns the number of steps
+    template < typename policy_t >
+    size_t simulate_block( policy_t &policy, env_t &env, size_t first, size_t last ) {
+
+        size_t total = 0;
+
+        for ( size_t t = 0; t < settings.horizon; t++ ) {
+            size_t active = 0;
+
+            for ( size_t lane = first; lane < last; lane++ ) {
+                if ( done[ lane ] ) { continue; }
+
+                const state_t &state = states[ lane ];
+                action_t action = policy.act( lane, env, state, gens[ lane ] );
+
+                reward_t reward = env.get_reward( state, action );
+                auto transition = env.get_transition( state, action );
+
+                if ( absorbing( env, state, action, transition, reward ) ) {
+                    done[ lane ] = 1;
+                    continue;
+                }
+
+                state_t next = gens[ lane ].sample_distribution( transition );
+
+                for ( size_t i = 0; i < objectives; i++ ) {
+                    returns[ lane * objectives + i ] += discounts[ lane ] * reward[i];
+                }
+
+                policy.observe( lane, state, action, reward, next );
+
+                discounts[ lane ] *= settings.discount;
+                states[ lane ] = next;
+                steps[ lane ]++;
+                active++;
+            }
+
+            total += active;
+            if ( active == 0 ) { break; }
+        }
+
+        return total;
+    }
+
+public:
+
+    BatchSimulator( const env_t &env, const BatchSettings &settings ) : settings( settings )
+                                                                      , pool( settings.threads )
+                                                                      , envs()
+                                                                      , initial_state()
+                                                                      , states( settings.lanes )
+                                                                      , discounts( settings.lanes )
+                                                                      , returns()
+                                                                      , steps( settings.lanes )
+                                                                      , done( settings.lanes )
+                                                                      , objectives( env.reward_range().first.size() ) {
+
+        size_t blocks = ( settings.lanes + block_size() - 1 ) / block_size();
+        envs.reserve( blocks );
+        for ( size_t i = 0; i < blocks; i++ ) {
+            envs.push_back( env );
+        }
+
+        if ( !envs.empty() ) {
+            initial_state = std::get< 0 >( envs[0].reset( derive_seed( settings.seed, SeedStream::Environment, 0 ) ) );
+        }
+
+        // one non-overlapping stream per lane
+        unsigned lane_seed = derive_seed( settings.seed, SeedStream::Solver, 0 );
+        PRNG master = ( lane_seed == 0 ) ? PRNG() : PRNG( lane_seed );
+
+        gens.reserve( settings.lanes );
+        for ( size_t lane = 0; lane < settings.lanes; lane++ ) {
+            gens.emplace_back( master.get_state() );
+            master.jump();
+        }
+    }
+
+    size_t num_lanes() const {
+        return settings.lanes;
+    }
+
+    size_t num_threads() const {
+        return pool.size();
+    }
+
+    // runs all lanes from the initial state, the generators continue from the last run
+    template < typename policy_t >
+    BatchResult run( policy_t &policy ) {
+
+        size_t lanes = settings.lanes;
+        returns.assign( lanes * objectives, 0 );
+        std::fill( states.begin(), states.end(), initial_state );
+        std::fill( discounts.begin(), discounts.end(), 1.0 );
+        std::fill( steps.begin(), steps.end(), 0 );
+        std::fill( done.begin(), done.end(), 0 );
+
+        for ( size_t lane = 0; lane < lanes; lane++ ) {
+            policy.reset( lane, initial_state );
+        }
+
+        auto start_time = std::chrono::steady_clock::now();
+
+        std::vector< std::future< size_t > > futures;
+        for ( size_t block = 0; block < envs.size(); block++ ) {
+            size_t first = block * block_size();
+            size_t last = std::min( lanes, first + block_size() );
+
+            futures.emplace_back( pool.submit( [ this, &policy, block, first, last ]{
+                return simulate_block( policy, envs[ block ], first, last );
+            }));
+        }
+
+        BatchResult res;
+        for ( auto &future : futures ) {
+            res.steps += future.get();
+        }
+
+        std::chrono::duration< double > elapsed = std::chrono::steady_clock::now() - start_time;
+
+        res.lanes = lanes;
+        res.objectives = objectives;
+        res.seconds = elapsed.count();
+        res.returns = returns;
+        res.lane_steps = steps;
+        res.terminated = done;
+        return res;
+    }
+};
@@ -1,28 +1,46 @@
 #pragma once
 
 #include <algorithm>
+#include <cassert>
+#include <cstring>
 #include <memory>
 #include <sstream>
 #include <set>
+#include <type_traits>
 #include "geometry/polygon.hpp"
 #include "models/environment.hpp"
+#include "models/mdp.hpp"
+#include "models/predecessors.hpp"
 #include "solvers/config.hpp"
+#include "solvers/value_iteration.hpp"
 #include "utils/eigen_types.hpp"
+#include "utils/profiling.hpp"
 #include "utils/prng.hpp"
+#include "utils/serialization.hpp"
 
 /* this class is used to interact with the underlying environment, recording
  * statistics, simulation, logging, etc.
  * reward_t to the actual reward type ( so std::vector< double > etc. )
  * while value_t will be equal to the type used to represent the reward
  * components for the underlying reward, so for example double 
+ *
+ * env_t is the type of the environment the calls are dispatched to, by
+ * default the virtual Environment interface, if a concrete ( final )
+ * environment class is given instead, e.g. MDP< double > or Racetrack, the
+ * calls are resolved at compile time and can be inlined into the solvers
  */
 
-template < typename state_t, typename action_t, typename reward_t , typename value_t >
+template < typename state_t, typename action_t, typename reward_t , typename value_t,
+           typename env_t = Environment< state_t, action_t, reward_t > >
 class EnvironmentWrapper{
     
+    static_assert( std::is_base_of_v< Environment< state_t, action_t, reward_t >, env_t >,
+                   "env_t has to implement the environment interface" );
+
     using bounds_ptr = std::unique_ptr< Bounds< value_t > >;
+    using PredecessorEntry = Predecessor< state_t, action_t >;
 
-    Environment< state_t, action_t, reward_t > *env;
+    env_t *env;
 
 
     /* it is possible to provide more precise initial bounds
@@ -39,19 +57,64 @@ class EnvironmentWrapper{
 
     ExplorationSettings< value_t > config;
 
+    /* per-state initial bounds, if set these override the global ones above
+     * for the respective states, see precompute_initial_bounds(), these are
+     * kept when the records are cleared */
+    std::map< state_t, std::pair< Point< value_t >, Point< value_t > > > initial_bounds;
+
     /* track update count for every state */
     std::map< state_t, size_t > update_count;
+
+    // sum of update_count, kept so that it can be queried cheaply
+    size_t total_updates = 0;
     std::map< std::tuple< state_t, action_t >, bounds_ptr > state_action_bounds;
     std::map< state_t, bounds_ptr > state_bounds;
 
+    /* actions that may still contribute to the bound of each discovered state,
+     * see eliminate_actions() */
+    std::map< state_t, std::vector< action_t > > active_actions;
+
+    /* states with converged bounds that are excluded from further updates,
+     * see try_freeze() */
+    std::set< state_t > frozen_states;
+
+    /* states with a state-action bound that changed since the last update of
+     * the state bound, other states can skip the hull recomputation */
+    std::set< state_t > dirty_states;
+
+    // state-action bounds closer than this are considered unchanged
+    static constexpr value_t change_tolerance = 1e-9;
+
+    /* largest precision the state bounds were pruned with since the records
+     * were cleared, see upper_right_hull() and revalidate_bounds() */
+    value_t records_precision = 0;
+
+    /* fingerprint of the discovered part of the model and the discount the
+     * records were computed for, see seal_records(), 0 if unknown */
+    uint64_t records_fingerprint = 0;
+    value_t records_discount = 0;
+
+    /* reverse edges of the discovered part of the state space, filled
+     * incrementally in discover() if config.track_predecessors is set, the
+     * entries of s' are all ( s, a, p ) where s is a discovered state */
+    std::map< state_t, std::vector< PredecessorEntry > > predecessors;
+
+    void record_predecessors( const state_t &s ) {
+        for ( const action_t &a : get_actions( s ) ) {
+            for ( const auto &[ succ, prob ] : get_transition( s, a ) ) {
+                predecessors[ succ ].push_back( { s, a, prob } );
+            }
+        }
+    }
+
 public:
 
     EnvironmentWrapper() : env( nullptr ), 
                            update_count(), 
                            state_action_bounds() {}
-    EnvironmentWrapper( Environment< state_t, action_t, reward_t > *env ) : env( env ), 
-                                                                            update_count(), 
-                                                                            state_action_bounds() {}
+    EnvironmentWrapper( env_t *env ) : env( env ), 
+                                       update_count(), 
+                                       state_action_bounds() {}
 
     using Observation = typename Environment< state_t, action_t, reward_t > :: Observation;
 
@@ -114,6 +177,13 @@ public:
         state_action_bounds.clear();
         state_bounds.clear();
         update_count.clear();
+        total_updates = 0;
+        active_actions.clear();
+        frozen_states.clear();
+        dirty_states.clear();
+        predecessors.clear();
+        records_precision = 0;
+        records_fingerprint = 0;
     }
 
     std::string name() const {
@@ -164,15 +234,57 @@ public:
 
 
 
-    // initializes all state_action bounds of s and the state bound
-    void init_bound( const state_t &s ) {
+    std::pair< std::vector< value_t >, std::vector< value_t > > get_initial_bound( const state_t &s ) const {
+        auto it = initial_bounds.find( s );
+        if ( it == initial_bounds.end() ) {
+            return get_initial_bound();
+        }
+
+        return it->second;
+    }
+
+
+    void set_initial_bounds( std::map< state_t, std::pair< Point< value_t >, Point< value_t > > > &&bounds ) {
+        initial_bounds = std::move( bounds );
+    }
+
+
+    /* if config.vi_initialization is set and the environment is a sparse
+     * MDP, computes per-state initial bounds by single objective value
+     * iteration ( see solvers/value_iteration.hpp ), starting from the
+     * global initial bound, the result is reused until the config changes */
+    void precompute_initial_bounds() {
+
+        if ( !config.vi_initialization || !initial_bounds.empty() ) { return; }
+
+        if constexpr ( std::is_same_v< state_t, size_t > && std::is_same_v< action_t, size_t > ) {
+            MDP< value_t > *mdp = nullptr;
+            if constexpr ( std::is_base_of_v< MDP< value_t >, env_t > ) { mdp = env; }
+            else                                                         { mdp = dynamic_cast< MDP< value_t > * >( env ); }
+
+            if ( mdp == nullptr ) { return; }
+
+            auto [ low, upp ] = get_initial_bound();
+            auto bounds = single_objective_bounds( *mdp, config, low, upp );
+
+            for ( size_t s = 0; s < bounds.size(); s++ ) {
+                initial_bounds.emplace_hint( initial_bounds.end(), s, std::move( bounds[s] ) );
+            }
+        }
+    }
+
+
+    /* initial lower / upper point of s, the global or precomputed bound,
+     * or the rewards of s if it is terminal, states without enabled actions
+     * keep the initial bound */
+    std::pair< std::vector< value_t >, std::vector< value_t > > get_initial_point( const state_t &s ) {
 
-        auto [ init_low, init_upp ] = get_initial_bound();
+        auto [ init_low, init_upp ] = get_initial_bound( s );
         
         /* if terminal state set using the enabled actions instead of 
          * initial bounds, if this is changed, setting of bounds for terminal
          * SSP states has to be handled somewhere else */
-        if ( is_terminal_state( s ) ) {
+        if ( is_terminal_state( s ) && !get_actions( s ).empty() ) {
             size_t act_idx = 0;
             for ( const action_t & avail_action : get_actions( s ) ) {
                 auto act_reward = get_expected_reward( s, avail_action );
@@ -200,11 +312,29 @@ public:
             }
         }
 
+        return std::make_pair( init_low, init_upp );
+    }
+
+
+    // initializes all state_action bounds of s and the state bound
+    void init_bound( const state_t &s ) {
+
+        auto [ init_low, init_upp ] = get_initial_point( s );
+
         for ( const action_t & avail_action : get_actions( s ) ) {
             Bounds< value_t > bound( { init_low }, { init_upp } );
             set_bound( s, avail_action, std::move( bound ) );
         }
 
+        active_actions[ s ] = get_actions( s );
+
+        // no actions to update, the initial bound is kept for good
+        if ( active_actions[ s ].empty() ) {
+            set_bound( s, Bounds< value_t >( { init_low }, { init_upp } ) );
+            frozen_states.insert( s );
+            return;
+        }
+
         update_bound( s );
     }
 
@@ -219,9 +349,25 @@ public:
      */
     void discover( const state_t &s ) {
         if ( state_bounds.find( s ) == state_bounds.end() ) {
+            PROFILE_SCOPE( ProfilePhase::Discover );
             update_count[ s ] = 0;
             init_bound( s );
+
+            if ( config.track_predecessors ) { record_predecessors( s ); }
+        }
+    }
+
+
+    /* returns all discovered ( s, a, p ) such that delta( s, a, state ) = p > 0
+     * the range is invalidated by the next discover() of a new state */
+    PredecessorRange< PredecessorEntry > get_predecessors( const state_t &state ) const {
+        auto it = predecessors.find( state );
+        if ( it == predecessors.end() ) {
+            return {};
         }
+
+        const auto &entries = it->second;
+        return { entries.data(), entries.data() + entries.size() };
     }
 
 
@@ -245,6 +391,79 @@ public:
         return true;
     }
 
+    /* actions of s that were not eliminated yet, these are the only ones
+     * considered in state bound updates and in the action heuristics */
+    const std::vector< action_t > &get_active_actions( const state_t &s ) const {
+        return active_actions.at( s );
+    }
+
+
+    /* permanently removes actions of s that can never contribute to the
+     * pareto curve of s, i.e. those whose upper bound lies in the downward
+     * closure of the lower bound formed by the other actions.
+     *
+     * this is sound since the upper bound U( s, a ) contains the true pareto
+     * curve Q( s, a ) in its downward closure, while the lower curves of the
+     * other actions lie below their true curves, so the true curve of the
+     * other actions dominates Q( s, a ) as well and a adds nothing to the
+     * curve of s. the bound of s itself is used as a cheap filter before the
+     * exact check against the remaining actions */
+    void eliminate_actions( const state_t &s ) {
+
+        PROFILE_SCOPE( ProfilePhase::ActionElimination );
+
+        std::vector< action_t > &actions = active_actions[ s ];
+        const Polygon< value_t > &state_lower = get_state_bound( s ).lower();
+
+        for ( size_t i = 0; ( i < actions.size() ) && ( actions.size() > 1 ); ) {
+
+            const Polygon< value_t > &candidate = get_state_action_bound( s, actions[i] ).upper();
+
+            if ( !state_lower.dominates( candidate ) ) { i++; continue; }
+
+            std::vector< Polygon< value_t > * > other_curves;
+            for ( size_t j = 0; j < actions.size(); j++ ) {
+                if ( j != i ) {
+                    other_curves.push_back( &( get_state_action_bound( s, actions[j] ).lower() ) );
+                }
+            }
+
+            // no pruning of vertices here, so that the check stays exact
+            if ( hull_union( other_curves, 0 ).dominates( candidate ) ) {
+                actions.erase( actions.begin() + i );
+            }
+            else { i++; }
+        }
+    }
+
+    bool is_frozen( const state_t &s ) const {
+        return frozen_states.find( s ) != frozen_states.end();
+    }
+
+
+    /* freezes s if its bounds are ( almost ) equal and all of its successors
+     * under the active actions are frozen as well, in which case no update
+     * can change the bound of s anymore, terminal states are frozen right
+     * after their initialization */
+    void try_freeze( const state_t &s ) {
+
+        if ( get_state_bound( s ).hausdorff_distance() >= config.freeze_ratio * config.precision ) {
+            return;
+        }
+
+        // s is inserted beforehand to handle self loops
+        frozen_states.insert( s );
+
+        for ( const action_t &a : get_active_actions( s ) ) {
+            for ( const auto &[ succ, _ ] : get_transition( s, a ) ) {
+                if ( !is_frozen( succ ) ) {
+                    frozen_states.erase( s );
+                    return;
+                }
+            }
+        }
+    }
+
     // returns L_i(s, a), U_i(s, a)
     Bounds< value_t >& get_state_action_bound( const state_t &s, const action_t &a ) {
         auto idx = std::make_pair( s, a );
@@ -262,8 +481,8 @@ public:
         return *state_bounds[ s ];
     }
 
-    void update_bound( const state_t &s, const action_t &a ) {
-        update_count[ s ]++;
+    // bellman backup of the bounds of s under a from the current state bounds
+    Bounds< value_t > backup( const state_t &s, const action_t &a ) {
         auto transition = get_transition( s, a );
         std::vector< Polygon< value_t > * > lower_curves, upper_curves;
         std::vector< double > probs;
@@ -274,29 +493,69 @@ public:
             probs.push_back( prob );
         }
 
-        Polygon< value_t > res_lower = weighted_minkowski_sum( lower_curves, probs );
-        Polygon< value_t > res_upper = weighted_minkowski_sum( upper_curves, probs );
+        Polygon< value_t > res_lower, res_upper;
+        {
+            PROFILE_SCOPE( ProfilePhase::MinkowskiSum );
+            res_lower = weighted_minkowski_sum( lower_curves, probs );
+            res_upper = weighted_minkowski_sum( upper_curves, probs );
+        }
         Bounds< value_t > result( std::move( res_lower ), std::move( res_upper ) );
 
         // r + \gamma * U, r + \gamma * L..
         result.multiply_bounds( config.discount_param );
         result.shift_bounds( get_expected_reward( s, a ) );
+        return result;
+    }
+
+    void update_bound( const state_t &s, const action_t &a ) {
+
+        if ( is_frozen( s ) ) { return; }
+
+        update_count[ s ]++;
+        total_updates++;
+        Bounds< value_t > result = backup( s, a );
+
+        // keep the old bound ( and s clean ) if nothing changed
+        if ( get_state_action_bound( s, a ).equals( result, change_tolerance ) ) { return; }
+
         set_bound( s, a, std::move( result ) ) ;
     }
 
     void update_bound( const state_t &s ) {
 
+        if ( is_frozen( s ) ) { return; }
+
+        // none of the state-action bounds changed, the hull would be the same
+        if ( dirty_states.find( s ) == dirty_states.end() ) {
+            if ( config.freeze_ratio > 0 ) { try_freeze( s ); }
+            return;
+        }
+
+        dirty_states.erase( s );
+
+        // skipped while the state is being initialized
+        if ( config.action_elimination && ( state_bounds.find( s ) != state_bounds.end() ) ) {
+            eliminate_actions( s );
+        }
+
         std::vector< Polygon< value_t > * > lower_curves, upper_curves;
-        for ( const action_t &action : get_actions( s ) ) {
+        for ( const action_t &action : get_active_actions( s ) ) {
             auto &bound = get_state_action_bound( s, action );
             lower_curves.push_back( &( bound.lower() ) );
             upper_curves.push_back( &( bound.upper() ) );
         }
 
-        Polygon< value_t > res_lower = hull_union( lower_curves, config.precision );
-        Polygon< value_t > res_upper = hull_union( upper_curves, config.precision );
+        Polygon< value_t > res_lower, res_upper;
+        {
+            PROFILE_SCOPE( ProfilePhase::HullUnion );
+            res_lower = hull_union( lower_curves, config.precision );
+            res_upper = hull_union( upper_curves, config.precision );
+        }
+        records_precision = std::max< value_t >( records_precision, config.precision );
 
         set_bound( s, Bounds< value_t > ( std::move( res_lower ), std::move( res_upper ) ) );
+
+        if ( config.freeze_ratio > 0 ) { try_freeze( s ); }
     }
 
 
@@ -305,6 +564,7 @@ public:
     void set_bound( const state_t &s, const action_t &a, Bounds< value_t > &&bound ) {
        auto idx = std::make_pair( s, a );
        state_action_bounds[ idx ] = std::make_unique< Bounds< value_t > > ( bound );
+       dirty_states.insert( s );
     }
 
     void set_bound( const state_t &s, Bounds< value_t > &&bound ) {
@@ -320,24 +580,522 @@ public:
     }
 
     void set_config( const ExplorationSettings< value_t > &_config ){
+
+        // precomputed bounds depend on the discount and the directions
+        if ( ( _config.discount_param != config.discount_param ) || ( _config.directions != config.directions ) ||
+             ( _config.lower_bound_init != config.lower_bound_init ) || ( _config.upper_bound_init != config.upper_bound_init ) ) {
+            initial_bounds.clear();
+        }
+
         config = _config;
     }
 
-    size_t get_update_num() const {
+    /* violations of the bellman inequalities by the bounds of s under the
+     * current environment and config, see Polygon::dominance_gap(), the
+     * first entry for the lower curve, which has to lie below the backup
+     * B( L )( s ) of the lower curves of the successors ( under some action ),
+     * the second for the upper curve, which has to lie above the backup
+     * B( U )( s ) of the upper curves ( under every action ), states without
+     * actions keep their initial bound and have no violations */
+    std::pair< value_t, value_t > bellman_gaps( const state_t &s ) {
+
+        std::vector< Bounds< value_t > > backups;
+        for ( const action_t &a : get_actions( s ) ) {
+            backups.push_back( backup( s, a ) );
+        }
 
-        size_t total = 0;
+        if ( backups.empty() ) { return { 0, 0 }; }
 
-        for ( const auto &[k, v] : update_count ) {
-            total += v;
+        const Bounds< value_t > &bound = get_state_bound( s );
+
+        std::vector< Polygon< value_t > * > lower_curves, upper_curves;
+        for ( auto &sa_bound : backups ) {
+            lower_curves.push_back( &( sa_bound.lower() ) );
+            upper_curves.push_back( &( sa_bound.upper() ) );
+        }
+
+        // pruned like in update_bound(), so that the solver's own curves pass
+        value_t upper_gap = 0;
+        Polygon< value_t > upper = hull_union( upper_curves, records_precision );
+        for ( const auto &v : upper.get_vertices() ) {
+            upper_gap = std::max( upper_gap, bound.upper().dominance_gap( v ) );
+        }
+
+        value_t lower_gap = 0;
+        Polygon< value_t > lower = hull_union( lower_curves, 0 );
+        for ( const auto &v : bound.lower().get_vertices() ) {
+            lower_gap = std::max( lower_gap, lower.dominance_gap( v ) );
+        }
+
+        return { lower_gap, upper_gap };
+    }
+
+
+    // shifts the lower or the upper curves of s and its actions by shift in every objective
+    void shift_bound( const state_t &s, bool lower, value_t shift ) {
+
+        Point< value_t > offset( get_state_bound( s ).lower().get_dimension(), shift );
+
+        for ( const action_t &a : get_actions( s ) ) {
+            Bounds< value_t > &bound = get_state_action_bound( s, a );
+            ( lower ? bound.lower() : bound.upper() ).shift_vector( offset );
+        }
+
+        Bounds< value_t > bound( get_state_bound( s ).lower(), get_state_bound( s ).upper() );
+        ( lower ? bound.lower() : bound.upper() ).shift_vector( offset );
+        set_bound( s, std::move( bound ) );
+    }
+
+
+    // resets the lower or the upper curves of s and its actions to the initial point
+    void reset_bound( const state_t &s, bool lower ) {
+
+        auto [ init_low, init_upp ] = get_initial_point( s );
+
+        for ( const action_t &a : get_actions( s ) ) {
+            const Bounds< value_t > &old = get_state_action_bound( s, a );
+            set_bound( s, a, lower ? Bounds< value_t >( Polygon< value_t >( { init_low } ), old.upper() )
+                                   : Bounds< value_t >( old.lower(), Polygon< value_t >( { init_upp } ) ) );
+        }
+
+        const Bounds< value_t > &old = get_state_bound( s );
+        set_bound( s, lower ? Bounds< value_t >( Polygon< value_t >( { init_low } ), old.upper() )
+                            : Bounds< value_t >( old.lower(), Polygon< value_t >( { init_upp } ) ) );
+    }
+
+
+    /* smallest shifts delta( s ) >= gaps( s ) + discount * max delta( s' ) over
+     * the successors s' of s ( under any action ), 0 for the fixed states,
+     * the iteration starts above the solution and stops once it changes
+     * little, all iterates are valid shifts */
+    std::vector< value_t > propagate_gaps( const std::vector< std::vector< size_t > > &successors,
+                                           const std::vector< value_t > &gaps,
+                                           const std::vector< bool > &fixed ) const {
+
+        value_t discount = config.discount_param;
+        value_t max_gap = 0;
+        for ( size_t i = 0; i < gaps.size(); i++ ) {
+            if ( !fixed[i] ) { max_gap = std::max( max_gap, gaps[i] ); }
+        }
+
+        if ( max_gap == 0 ) { return std::vector< value_t >( gaps.size(), 0 ); }
+
+        std::vector< value_t > shifts( gaps.size(), max_gap / ( 1 - discount ) );
+
+        for ( size_t i = 0; i < gaps.size(); i++ ) {
+            if ( fixed[i] ) { shifts[i] = 0; }
+        }
+
+        for ( size_t sweep = 0; sweep < 10000; sweep++ ) {
+            value_t change = 0;
+
+            for ( size_t i = 0; i < gaps.size(); i++ ) {
+                if ( fixed[i] ) { continue; }
+
+                value_t succ_shift = 0;
+                for ( size_t j : successors[i] ) {
+                    succ_shift = std::max( succ_shift, shifts[j] );
+                }
+
+                value_t shift = gaps[i] + discount * succ_shift;
+                change = std::max( change, shifts[i] - shift );
+                shifts[i] = shift;
+            }
+
+            if ( change < 1e-3 * max_gap ) { break; }
+        }
+
+        return shifts;
+    }
+
+
+    /* hash of the transitions and rewards of all discovered states, the
+     * successors are identified by their position among the discovered
+     * states, so that the state type need not be hashable, never 0 */
+    uint64_t model_fingerprint() {
+
+        std::vector< state_t > states = discovered_states();
+        uint64_t hash = 0;
+
+        auto mix = [ &hash ]( uint64_t word ) {
+            hash ^= word;
+            hash = splitmix64( hash );
+        };
+
+        auto mix_value = [ &mix ]( double value ) {
+            uint64_t bits;
+            std::memcpy( &bits, &value, sizeof( bits ) );
+            mix( bits );
+        };
+
+        for ( const state_t &s : states ) {
+            for ( const action_t &a : get_actions( s ) ) {
+                for ( const auto &[ succ, prob ] : get_transition( s, a ) ) {
+                    auto it = std::lower_bound( states.begin(), states.end(), succ );
+                    bool found = ( it != states.end() ) && !( succ < *it );
+                    mix( found ? static_cast< uint64_t >( it - states.begin() ) : states.size() );
+                    mix_value( prob );
+                }
+
+                for ( auto reward : get_expected_reward( s, a ) ) {
+                    mix_value( reward );
+                }
+
+                // separates the actions
+                mix( 0x5eed );
+            }
+
+            mix( 0x57a7e );
         }
 
-        return total;
+        return ( hash == 0 ) ? 1 : hash;
+    }
+
+
+    /* remembers the model and discount the current records are valid for,
+     * called by the solvers at the end of each solve, revalidate_bounds()
+     * keeps the records as they are if neither changed */
+    void seal_records() {
+        records_fingerprint = model_fingerprint();
+        records_discount = config.discount_param;
+    }
+
+
+    /* prepares the records of a previous run ( with other precision,
+     * discount, or environment parameters ) for a warm started solve, see
+     * config.warm_start:
+     *
+     * if the discount and the discovered part of the model are those the
+     * records were sealed with ( see seal_records() ), the records are still
+     * exactly as sound as at the end of that run, they are kept and only the
+     * states are unfrozen ( the precision may have been tightened ).
+     *
+     * otherwise
+     *
+     *  the undiscovered successors of the discovered states are discovered,
+     *  these are fixed at their initial bounds, since their own successors
+     *  may be undiscovered, eliminated actions are restored and all states
+     *  are unfrozen, then the curves whose bellman gap eps( s ) ( see
+     *  bellman_gaps() ) exceeds the precision are reset to the initial ones,
+     *  until all remaining curves pass.
+     *
+     *  the kept curves of s are then shifted by delta( s ), down for the
+     *  lower and up for the upper curves, where delta( s ) >= eps( s ) +
+     *  discount * delta( s' ) for all successors s' of s ( see
+     *  propagate_gaps() ). the shifted curves L' satisfy L' <= B( L' ) ( resp.
+     *  U' >= B( U' ) ), and since the initial bounds are sound and B is a
+     *  contraction, every lower curve lies below and every upper curve above
+     *  the true pareto curve of its state.
+     *
+     *  the gaps of the upper curves are measured against the backup pruned
+     *  with the precision of the records, i.e. the guarantee for the upper
+     *  curves is that of the updates themselves ( see upper_right_hull() ),
+     *  the one for the lower curves is exact.
+     *
+     *  finally every state but the fixed ones is backed up once from the
+     *  validated bounds
+     *
+     *  for discount 1 the inequalities do not imply soundness ( e.g. any
+     *  value passes on a cycle without rewards ), all records are cleared
+     *
+     * returns the number of reset curves */
+    size_t revalidate_bounds() {
+
+        if ( ( records_fingerprint != 0 ) && ( records_discount == config.discount_param ) &&
+             ( model_fingerprint() == records_fingerprint ) ) {
+
+            frozen_states.clear();
+            for ( const auto &[ s, actions ] : active_actions ) {
+                if ( actions.empty() ) { frozen_states.insert( s ); }
+            }
+
+            return 0;
+        }
+
+        if ( config.discount_param >= 1 ) {
+            size_t curves = 2 * discovered_states().size();
+            clear_records();
+            return curves;
+        }
+
+        frozen_states.clear();
+
+        std::vector< state_t > old_states = discovered_states();
+        for ( const state_t &s : old_states ) {
+            for ( const action_t &a : get_actions( s ) ) {
+                for ( const auto &[ succ, _ ] : get_transition( s, a ) ) {
+                    discover( succ );
+                }
+            }
+        }
+
+        std::vector< state_t > states = discovered_states();
+
+        // newly discovered states keep their initial bounds, see above
+        std::vector< bool > fresh( states.size() );
+        for ( size_t i = 0; i < states.size(); i++ ) {
+            fresh[i] = !std::binary_search( old_states.begin(), old_states.end(), states[i] );
+        }
+
+        predecessors.clear();
+        for ( const state_t &s : states ) {
+            active_actions[ s ] = get_actions( s );
+            if ( active_actions[ s ].empty() ) { frozen_states.insert( s ); }
+            if ( config.track_predecessors ) { record_predecessors( s ); }
+        }
+
+        // gaps due to the pruning of the curves are kept, see upper_right_hull()
+        value_t max_gap = std::max( records_precision, static_cast< value_t >( config.precision ) );
+
+        // initial bounds are sound, reset and fresh curves are not checked again
+        std::vector< bool > reset_lower( fresh ), reset_upper( fresh );
+        std::vector< value_t > lower_gaps( states.size(), 0 ), upper_gaps( states.size(), 0 );
+        size_t resets = 0;
+        bool changed = true;
+
+        // the gaps of the last pass are those of the final curves
+        while ( changed ) {
+            changed = false;
+
+            for ( size_t i = 0; i < states.size(); i++ ) {
+                if ( reset_lower[i] && reset_upper[i] ) { continue; }
+
+                std::tie( lower_gaps[i], upper_gaps[i] ) = bellman_gaps( states[i] );
+
+                if ( !reset_lower[i] && ( lower_gaps[i] > max_gap ) ) {
+                    reset_bound( states[i], true );
+                    reset_lower[i] = changed = true;
+                    resets++;
+                }
+
+                if ( !reset_upper[i] && ( upper_gaps[i] > max_gap ) ) {
+                    reset_bound( states[i], false );
+                    reset_upper[i] = changed = true;
+                    resets++;
+                }
+            }
+        }
+
+        // successors of each state by their index in states, all discovered unless fresh
+        std::vector< std::vector< size_t > > successors( states.size() );
+        for ( size_t i = 0; i < states.size(); i++ ) {
+            if ( fresh[i] ) { continue; }
+            for ( const action_t &a : get_actions( states[i] ) ) {
+                for ( const auto &[ succ, _ ] : get_transition( states[i], a ) ) {
+                    successors[i].push_back( std::lower_bound( states.begin(), states.end(), succ ) - states.begin() );
+                }
+            }
+        }
+
+        std::vector< value_t > lower_shifts = propagate_gaps( successors, lower_gaps, reset_lower );
+        std::vector< value_t > upper_shifts = propagate_gaps( successors, upper_gaps, reset_upper );
+
+        for ( size_t i = 0; i < states.size(); i++ ) {
+            if ( lower_shifts[i] > 0 ) { shift_bound( states[i], true, -lower_shifts[i] ); }
+            if ( upper_shifts[i] > 0 ) { shift_bound( states[i], false, upper_shifts[i] ); }
+        }
+
+        for ( size_t i = 0; i < states.size(); i++ ) {
+            if ( fresh[i] ) { continue; }
+            for ( const action_t &a : get_active_actions( states[i] ) ) {
+                update_bound( states[i], a );
+            }
+            update_bound( states[i] );
+        }
+
+        return resets;
+    }
+
+
+    /* replaces the records of this wrapper by copies of those of other, e.g.
+     * to warm start from a solver of another environment with the same
+     * states, the environment, config and initial bounds are kept */
+    void copy_records_from( const EnvironmentWrapper &other ) {
+
+        auto copy_bounds = []( const auto &from, auto &to ){
+            to.clear();
+            for ( const auto &[ key, bound ] : from ) {
+                to.emplace_hint( to.end(), key, bound ? std::make_unique< Bounds< value_t > >( *bound ) : nullptr );
+            }
+        };
+
+        copy_bounds( other.state_action_bounds, state_action_bounds );
+        copy_bounds( other.state_bounds, state_bounds );
+
+        update_count = other.update_count;
+        total_updates = other.total_updates;
+        active_actions = other.active_actions;
+        frozen_states = other.frozen_states;
+        dirty_states = other.dirty_states;
+        predecessors = other.predecessors;
+        records_precision = other.records_precision;
+        records_fingerprint = other.records_fingerprint;
+        records_discount = other.records_discount;
+    }
+
+
+    /* writes the records ( bounds, update counts, active actions, frozen and
+     * dirty states ) to out, see utils/serialization.hpp, each state is
+     * followed by its bounds and those of its actions, curves are stored as
+     * their vertex counts and raw coordinates only, the facets and cached
+     * distances are recomputed by load_records() */
+    void save_records( BinaryWriter &out ) const {
+
+        uint64_t dim = reward_range().first.size();
+
+        // discovered states, counted without collecting them
+        uint64_t states = 0;
+        for ( const auto &[ s, bound ] : state_bounds ) { states += ( bound != nullptr ); }
+
+        out.write( dim );
+        out.write( states );
+        out.write( static_cast< uint64_t >( total_updates ) );
+        out.write( records_precision );
+
+        auto write_curve = [ & ]( const Polygon< value_t > &curve ){
+            out.write( static_cast< uint32_t >( curve.size() ) );
+            for ( const auto &v : curve.get_vertices() ) {
+                assert( v.size() == dim );
+                out.write_array( v.data(), dim );
+            }
+        };
+
+        // both maps are sorted by the state first
+        auto sa_it = state_action_bounds.begin();
+
+        for ( const auto &[ s, bound ] : state_bounds ) {
+            if ( !bound ) { continue; }
+
+            while ( ( sa_it != state_action_bounds.end() ) && ( std::get< 0 >( sa_it->first ) < s ) ) { sa_it++; }
+            auto sa_end = sa_it;
+            uint32_t sa_count = 0;
+            for ( ; ( sa_end != state_action_bounds.end() ) && !( s < std::get< 0 >( sa_end->first ) ); sa_end++ ) {
+                sa_count += ( sa_end->second != nullptr );
+            }
+
+            auto count = update_count.find( s );
+            uint8_t flags = ( is_frozen( s ) ? 1 : 0 ) | ( ( dirty_states.find( s ) != dirty_states.end() ) ? 2 : 0 );
+
+            out.write( s );
+            out.write( static_cast< uint64_t >( ( count == update_count.end() ) ? 0 : count->second ) );
+            out.write( flags );
+            write_curve( bound->lower() );
+            write_curve( bound->upper() );
+
+            auto active = active_actions.find( s );
+            out.write( ( active == active_actions.end() ) ? std::vector< action_t >() : active->second );
+
+            out.write( sa_count );
+            for ( ; sa_it != sa_end; sa_it++ ) {
+                if ( !sa_it->second ) { continue; }
+                out.write( std::get< 1 >( sa_it->first ) );
+                write_curve( sa_it->second->lower() );
+                write_curve( sa_it->second->upper() );
+            }
+        }
+    }
+
+
+    /* replaces the records by those written by save_records(), the config
+     * has to be set beforehand ( the facets of the state bounds depend on
+     * it ), predecessors are rebuilt if config.track_predecessors is set */
+    void load_records( BinaryReader &in ) {
+
+        clear_records();
+
+        uint64_t dim = in.read< uint64_t >();
+        if ( dim != reward_range().first.size() ) {
+            throw std::runtime_error( "records with a different number of objectives" );
+        }
+
+        uint64_t states = in.read< uint64_t >();
+        total_updates = in.read< uint64_t >();
+        in.read( records_precision );
+
+        auto read_curve = [ & ](){
+            std::vector< Point< value_t > > vertices( in.read< uint32_t >(), Point< value_t >( dim ) );
+            for ( auto &v : vertices ) {
+                in.read_array( v.data(), dim );
+            }
+            return Polygon< value_t >( std::move( vertices ) );
+        };
+
+        for ( uint64_t i = 0; i < states; i++ ) {
+
+            state_t s = in.read< state_t >();
+            update_count[ s ] = in.read< uint64_t >();
+
+            uint8_t flags = in.read< uint8_t >();
+            if ( flags & 1 ) { frozen_states.insert( s ); }
+            if ( flags & 2 ) { dirty_states.insert( s ); }
+
+            Polygon< value_t > lower = read_curve();
+            set_bound( s, Bounds< value_t >( std::move( lower ), read_curve() ) );
+
+            in.read( active_actions[ s ] );
+
+            uint32_t sa_count = in.read< uint32_t >();
+            for ( uint32_t j = 0; j < sa_count; j++ ) {
+                action_t a = in.read< action_t >();
+                Polygon< value_t > sa_lower = read_curve();
+                state_action_bounds[ std::make_pair( s, a ) ] = std::make_unique< Bounds< value_t > >( std::move( sa_lower ), read_curve() );
+            }
+        }
+
+        if ( config.track_predecessors ) {
+            for ( const state_t &s : discovered_states() ) {
+                record_predecessors( s );
+            }
+        }
+    }
+
+    const ExplorationSettings< value_t > &get_config() const {
+        return config;
+    }
+
+    bool is_discovered( const state_t &s ) const {
+        auto it = state_bounds.find( s );
+        return ( it != state_bounds.end() ) && it->second;
+    }
+
+    // all states with an initialized bound, in increasing order
+    std::vector< state_t > discovered_states() const {
+        std::vector< state_t > res;
+        res.reserve( state_bounds.size() );
+        for ( const auto &[ s, bound ] : state_bounds ) {
+            if ( bound ) { res.push_back( s ); }
+        }
+        return res;
+    }
+
+    size_t get_update_num() const {
+        return total_updates;
     }
 
     size_t num_states_explored() const {
         return state_bounds.size();
     }
 
+    size_t num_states_frozen() const {
+        return frozen_states.size();
+    }
+
+    /* heap memory held by the vertices of all stored state and state-action
+     * bounds, in bytes ( map nodes are not included ) */
+    size_t bound_memory_bytes() const {
+        size_t bytes = 0;
+
+        for ( const auto &[ _, bound ] : state_bounds ) {
+            bytes += sizeof( Bounds< value_t > ) + bound->memory_bytes();
+        }
+
+        for ( const auto &[ _, bound ] : state_action_bounds ) {
+            bytes += sizeof( Bounds< value_t > ) + bound->memory_bytes();
+        }
+
+        return bytes;
+    }
+
     void write_exploration_logs( std::string filename, bool output_all_bounds ) const {
 
         std::ofstream out( filename + "-logs.txt" , std::ios_base::app );
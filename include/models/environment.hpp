@@ -1,9 +1,11 @@
 #pragma once
 
+#include <ostream>
 #include <string>
 #include <vector>
 #include <tuple>
 #include <map>
+#include <utility>
 
 /* 
  *  environment interface to use when interacting with the solver
@@ -40,3 +42,33 @@ public:
 
 };
 
+
+// deduce the template arguments of the Environment base class of env_t
+template < typename state_t, typename action_t, typename reward_t >
+std::tuple< state_t, action_t, reward_t > environment_types( const Environment< state_t, action_t, reward_t > & );
+
+template < typename env_t >
+using environment_state_t = std::tuple_element_t< 0, decltype( environment_types( std::declval< const env_t & >() ) ) >;
+
+template < typename env_t >
+using environment_action_t = std::tuple_element_t< 1, decltype( environment_types( std::declval< const env_t & >() ) ) >;
+
+template < typename env_t >
+using environment_reward_t = std::tuple_element_t< 2, decltype( environment_types( std::declval< const env_t & >() ) ) >;
+
+
+/* trace output of states and actions, pairs ( e.g. the actions of the
+ * racetrack ) are printed element-wise, so that the solvers do not depend on
+ * an operator<< for std::pair being declared before them, other types use
+ * their operator<< */
+template < typename T >
+void print_trace( std::ostream &os, const T &value ) {
+    os << value;
+}
+
+template < typename T, typename U >
+void print_trace( std::ostream &os, const std::pair< T, U > &value ) {
+    print_trace( os, value.first );
+    os << "; ";
+    print_trace( os, value.second );
+}
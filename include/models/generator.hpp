@@ -0,0 +1,199 @@
+# pragma once
+
+# include <algorithm>
+# include <fstream>
+# include <iomanip>
+# include <stdexcept>
+# include <string>
+# include <utility>
+# include <vector>
+# include "models/mdp.hpp"
+# include "utils/eigen_types.hpp"
+# include "utils/prng.hpp"
+
+/*
+ * generator of synthetic multi-objective MDPs for scaling benchmarks
+ *
+ * states 0 .. states - 1, the initial state is 0 and the last state is an
+ * absorbing sink ( one self loop action with zero reward ), every other state
+ * has the same number of actions, each with branching successors
+ *
+ * successors are chosen from the next forward_window states ( which makes the
+ * model a DAG leading to the sink ), except with probability back_edge_prob,
+ * when they are chosen uniformly from all states, closing cycles
+ *
+ * rewards of each objective are drawn from [ 0, reward_spread ], with
+ * conflict > 0 the second objective is pulled towards reward_spread - r1,
+ * so that the objectives trade off and the pareto curve has more vertices
+ *
+ * the same settings ( including the seed ) always give the same model
+ */
+
+struct GeneratorSettings {
+    size_t states = 1000;
+    size_t actions = 3;
+    size_t branching = 2;
+    size_t forward_window = 10;
+    double back_edge_prob = 0.1;
+
+    size_t objectives = 2;
+    double reward_spread = 10;
+    double conflict = 0.8;
+
+    unsigned seed = 1;
+};
+
+
+// one enabled ( state, action ) pair of the generated model
+struct GeneratedChoice {
+    size_t state, action;
+    std::vector< std::pair< size_t, double > > successors;
+    std::vector< double > rewards;
+};
+
+
+inline std::vector< GeneratedChoice > generate_choices( const GeneratorSettings &settings ) {
+
+    if ( ( settings.states < 2 ) || ( settings.actions == 0 ) || ( settings.branching == 0 ) || ( settings.objectives == 0 ) ) {
+        throw std::runtime_error( "generator needs at least two states, one action, successor and objective" );
+    }
+
+    PRNG gen( settings.seed );
+    std::vector< GeneratedChoice > choices;
+
+    size_t sink = settings.states - 1;
+
+    for ( size_t s = 0; s < sink; s++ ) {
+        for ( size_t a = 0; a < settings.actions; a++ ) {
+
+            GeneratedChoice choice{ s, a, {}, std::vector< double >( settings.objectives ) };
+
+            size_t window = std::min( settings.forward_window, sink - s );
+            size_t branching = std::min( settings.branching, settings.states );
+
+            // once the window is used up ( near the sink ), all states are allowed
+            std::vector< size_t > succs;
+            size_t forward_used = 0;
+
+            while ( succs.size() < branching ) {
+                bool forward = ( forward_used < window ) && ( gen.rand_float() >= settings.back_edge_prob );
+                size_t succ = forward ? s + gen.rand_int( 1, window ) : gen.rand_int( 0, sink );
+
+                if ( std::find( succs.begin(), succs.end(), succ ) != succs.end() ) { continue; }
+
+                if ( ( succ > s ) && ( succ <= s + window ) ) { forward_used++; }
+                succs.push_back( succ );
+            }
+
+            std::sort( succs.begin(), succs.end() );
+
+            // random distribution over the successors, bounded away from zero
+            std::vector< double > weights;
+            double total = 0;
+            for ( size_t i = 0; i < succs.size(); i++ ) {
+                weights.push_back( 0.1 + gen.rand_float() );
+                total += weights.back();
+            }
+
+            for ( size_t i = 0; i < succs.size(); i++ ) {
+                choice.successors.emplace_back( succs[i], weights[i] / total );
+            }
+
+            for ( size_t i = 0; i < settings.objectives; i++ ) {
+                choice.rewards[i] = gen.rand_float() * settings.reward_spread;
+            }
+
+            if ( settings.objectives >= 2 ) {
+                choice.rewards[1] = settings.conflict * ( settings.reward_spread - choice.rewards[0] )
+                                  + ( 1 - settings.conflict ) * choice.rewards[1];
+            }
+
+            choices.emplace_back( std::move( choice ) );
+        }
+    }
+
+    choices.push_back( GeneratedChoice{ sink, 0, { { sink, 1.0 } }, std::vector< double >( settings.objectives, 0 ) } );
+    return choices;
+}
+
+
+// builds the model directly, same layout as the models built by PrismParser
+inline MDP< double > generate_mdp( const GeneratorSettings &settings ) {
+
+    std::vector< GeneratedChoice > choices = generate_choices( settings );
+
+    std::vector< std::vector< Eigen::Triplet< double > > > transition_triplets( settings.states );
+    std::vector< std::vector< Eigen::Triplet< double > > > reward_triplets( settings.objectives );
+
+    std::vector< double > min_rew( settings.objectives, 0 ), max_rew( settings.objectives, 0 );
+
+    for ( const auto &choice : choices ) {
+        for ( const auto &[ succ, prob ] : choice.successors ) {
+            transition_triplets[ choice.state ].emplace_back( choice.action, succ, prob );
+        }
+
+        for ( size_t i = 0; i < settings.objectives; i++ ) {
+            reward_triplets[i].emplace_back( choice.action, choice.state, choice.rewards[i] );
+            min_rew[i] = std::min( min_rew[i], choice.rewards[i] );
+            max_rew[i] = std::max( max_rew[i], choice.rewards[i] );
+        }
+    }
+
+    Matrix3D< double > transitions;
+    for ( const auto &triplets : transition_triplets ) {
+        Matrix2D< double > matrix( settings.actions, settings.states );
+        matrix.setFromTriplets( triplets.begin(), triplets.end() );
+        matrix.makeCompressed();
+        transitions.emplace_back( std::move( matrix ) );
+    }
+
+    // reward matrices are A x S, one column for each state
+    Matrix3D< double > rewards;
+    for ( const auto &triplets : reward_triplets ) {
+        Matrix2D< double > matrix( settings.actions, settings.states );
+        matrix.setFromTriplets( triplets.begin(), triplets.end() );
+        matrix.makeCompressed();
+        rewards.emplace_back( std::move( matrix ) );
+    }
+
+    return MDP< double >( std::move( transitions ), std::move( rewards ), { min_rew, max_rew }, 0 );
+}
+
+
+/* writes the model in the explicit PRISM format, as a transition file and one
+ * transition reward file per objective ( reward_prefix1.trew, ... ), which can
+ * be loaded by PrismParser */
+inline void write_prism( const GeneratorSettings &settings,
+                         const std::string &transition_file,
+                         const std::string &reward_prefix ) {
+
+    std::vector< GeneratedChoice > choices = generate_choices( settings );
+
+    size_t num_transitions = 0;
+    for ( const auto &choice : choices ) {
+        num_transitions += choice.successors.size();
+    }
+
+    std::ofstream tra( transition_file );
+
+    // probabilities of each choice have to sum up to 1 in the parser
+    tra << std::setprecision( 17 );
+    tra << settings.states << " " << choices.size() << " " << num_transitions << "\n";
+    for ( const auto &choice : choices ) {
+        for ( const auto &[ succ, prob ] : choice.successors ) {
+            tra << choice.state << " " << choice.action << " " << succ << " " << prob << "\n";
+        }
+    }
+
+    // transition rewards, the same reward for every successor of a choice
+    for ( size_t i = 0; i < settings.objectives; i++ ) {
+        std::ofstream trew( reward_prefix + std::to_string( i + 1 ) + ".trew" );
+        trew << std::setprecision( 17 );
+        trew << settings.states << " " << choices.size() << " " << num_transitions << "\n";
+        for ( const auto &choice : choices ) {
+            for ( const auto &[ succ, _ ] : choice.successors ) {
+                trew << choice.state << " " << choice.action << " " << succ << " " << choice.rewards[i] << "\n";
+            }
+        }
+    }
+}
@@ -1,7 +1,10 @@
 #pragma once
 
+#include <algorithm>
+#include <type_traits>
 #include <vector>
 #include "models/environment.hpp"
+#include "models/predecessors.hpp"
 #include "utils/prng.hpp"
 #include "utils/eigen_types.hpp"
 
@@ -11,7 +14,7 @@
 
 
 template < typename reward_t >
-class MDP : public Environment< size_t, size_t , std::vector< reward_t > > {
+class MDP final : public Environment< size_t, size_t , std::vector< reward_t > > {
 
     typedef std::vector< reward_t > reward_vec ;
     typedef Matrix3D< double > TransitionMatrix;
@@ -39,8 +42,51 @@ class MDP : public Environment< size_t, size_t , std::vector< reward_t > > {
 
     RewardMatrix reward_models;
 
+    /* reverse CSR index of the transition matrices, predecessors of state s
+     * are stored in predecessor_entries[ predecessor_offsets[s] ..
+     * predecessor_offsets[s + 1] ), built once the model is loaded */
+    std::vector< size_t > predecessor_offsets;
+    std::vector< Predecessor< size_t, size_t > > predecessor_entries;
+
     PRNG gen;
 
+    void build_predecessor_index() {
+
+        size_t num_states = transitions.size();
+
+        // successors may have no outgoing transitions of their own
+        for ( const auto &state_matrix : transitions ) {
+            num_states = std::max( num_states, static_cast< size_t >( state_matrix.cols() ) );
+        }
+
+        predecessor_offsets.assign( num_states + 1, 0 );
+
+        // count the incoming edges of each state
+        for ( size_t s = 0; s < transitions.size(); s++ ) {
+            for ( Eigen::Index a = 0; a < transitions[s].outerSize(); a++ ) {
+                for ( Matrix2D< double >::InnerIterator it( transitions[s], a ); it; ++it ) {
+                    predecessor_offsets[ it.col() + 1 ]++;
+                }
+            }
+        }
+
+        for ( size_t s = 0; s < num_states; s++ ) {
+            predecessor_offsets[ s + 1 ] += predecessor_offsets[ s ];
+        }
+
+        // fill the entries, using a copy of the offsets as insertion cursors
+        std::vector< size_t > cursors( predecessor_offsets.begin(), predecessor_offsets.end() - 1 );
+        predecessor_entries.resize( predecessor_offsets.back() );
+
+        for ( size_t s = 0; s < transitions.size(); s++ ) {
+            for ( Eigen::Index a = 0; a < transitions[s].outerSize(); a++ ) {
+                for ( Matrix2D< double >::InnerIterator it( transitions[s], a ); it; ++it ) {
+                    predecessor_entries[ cursors[ it.col() ]++ ] = { s, static_cast< size_t >( a ), it.value() };
+                }
+            }
+        }
+    }
+
 public:
     MDP() : transitions() ,
             reward_models() ,
@@ -56,7 +102,7 @@ public:
                               reward_bounds( other.reward_range() ),
                               initial_state( other.get_initial_state() ),
                               current_state( other.get_initial_state() ),
-                              gen(  ){ }
+                              gen(  ){ build_predecessor_index(); }
 
 
     MDP( const TransitionMatrix& transitions, const RewardMatrix& rewards, 
@@ -66,7 +112,7 @@ public:
               reward_bounds( reward_bounds ) ,
               initial_state( s ) ,
               current_state( s ) ,
-              gen(){}
+              gen(){ build_predecessor_index(); }
 
 
     // move constructor
@@ -77,7 +123,7 @@ public:
               reward_bounds( reward_bounds ) ,
               initial_state( s ) ,
               current_state( s ) ,
-              gen(){}
+              gen(){ build_predecessor_index(); }
 
 
     std::vector< size_t > get_actions( const size_t &state ) const override {
@@ -108,6 +154,52 @@ public:
         return initial_state;
     }
 
+    // states including those that only appear as successors
+    size_t num_states() const {
+        return predecessor_offsets.empty() ? transitions.size() : predecessor_offsets.size() - 1;
+    }
+
+    // nonzero entries of delta( s, a, s' )
+    size_t num_transitions() const {
+        size_t total = 0;
+        for ( const auto &state_matrix : transitions ) {
+            total += state_matrix.nonZeros();
+        }
+        return total;
+    }
+
+    /* memory footprint of the model in bytes, i.e. the sparse transition and
+     * reward matrices ( values, inner and outer indices ) and the predecessor
+     * index, computed from the sizes of the compressed storage */
+    size_t memory_bytes() const {
+        auto matrix_bytes = [ ]( const auto &matrices ) {
+            size_t bytes = matrices.capacity() * sizeof( matrices[0] );
+            for ( const auto &matrix : matrices ) {
+                using matrix_t = std::decay_t< decltype( matrix ) >;
+                using scalar_t = typename matrix_t::Scalar;
+                using index_t = typename matrix_t::StorageIndex;
+
+                bytes += matrix.data().allocatedSize() * ( sizeof( scalar_t ) + sizeof( index_t ) );
+                bytes += ( matrix.outerSize() + 1 ) * sizeof( index_t );
+            }
+            return bytes;
+        };
+
+        return matrix_bytes( transitions ) + matrix_bytes( reward_models )
+             + predecessor_offsets.capacity() * sizeof( size_t )
+             + predecessor_entries.capacity() * sizeof( Predecessor< size_t, size_t > );
+    }
+
+    // all ( s, a, delta( s, a, state ) ) triplets with nonzero probability
+    PredecessorRange< Predecessor< size_t, size_t > > get_predecessors( size_t state ) const {
+        if ( state + 1 >= predecessor_offsets.size() ) {
+            return {};
+        }
+
+        const auto *data = predecessor_entries.data();
+        return { data + predecessor_offsets[ state ], data + predecessor_offsets[ state + 1 ] };
+    }
+
 
 
     std::map< size_t, double > get_transition( const size_t &state, 
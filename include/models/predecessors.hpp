@@ -0,0 +1,60 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+/*
+ * reverse edges of a model, for a state s' these are all the ( s, a ) pairs
+ * that lead to s' with a nonzero probability, used by solvers that propagate
+ * changes of bounds backwards instead of sweeping the whole state space
+ */
+
+template < typename state_t, typename action_t >
+struct Predecessor {
+
+    // predecessor state and the action played in it
+    state_t state;
+    action_t action;
+
+    // delta( state, action, s' )
+    double probability;
+};
+
+
+/* non-owning view over a contiguous block of predecessor entries, returned
+ * by the models so that iterating over predecessors does not allocate
+ *
+ * the view is invalidated by any operation that modifies the underlying index
+ * ( i.e. discovering new states in the environment wrapper )
+ */
+template < typename entry_t >
+class PredecessorRange {
+
+    const entry_t *first;
+    const entry_t *last;
+
+public:
+
+    PredecessorRange() : first( nullptr ), last( nullptr ) {}
+    PredecessorRange( const entry_t *first, const entry_t *last ) : first( first ), last( last ) {}
+
+    const entry_t *begin() const {
+        return first;
+    }
+
+    const entry_t *end() const {
+        return last;
+    }
+
+    size_t size() const {
+        return last - first;
+    }
+
+    bool empty() const {
+        return first == last;
+    }
+
+    const entry_t &operator[]( size_t i ) const {
+        return first[i];
+    }
+};
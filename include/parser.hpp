@@ -10,6 +10,7 @@
 # include <vector>
 # include "models/mdp.hpp"
 # include "utils/eigen_types.hpp"
+# include "utils/memory.hpp"
 # include "utils/prng.hpp"
 
 /*
@@ -101,6 +102,14 @@ struct TripletList {
         return std::make_pair( min->second, max->second );
     }
 
+    /* approximate heap memory of both maps in bytes, each node of a std::map
+     * holds the key-value pair along with the tree links ( ~ 32 bytes ) */
+    size_t memory_bytes() const {
+        constexpr size_t node_overhead = 32;
+        return prob_sums.size() * ( node_overhead + sizeof( std::pair< const size_t, double > ) )
+             + triplets.size() * ( node_overhead + sizeof( std::pair< const std::pair< size_t, size_t >, double > ) );
+    }
+
     /* build a 2D matrix out of the triplet map, used when constructing the
      * final model */
     Matrix2D<double> build_matrix(){
@@ -123,6 +132,22 @@ struct TripletList {
 };
 
 
+/* memory statistics of the last parse_model() call, peak resident set sizes
+ * are in kB ( since the start of the call, see utils/memory.hpp ) */
+struct ParseStats {
+
+    // size of the triplet maps once all files were loaded
+    size_t triplet_bytes = 0;
+
+    size_t transitions_peak_rss = 0;
+    size_t rewards_peak_rss = 0;
+    size_t build_peak_rss = 0;
+
+    // footprint of the resulting model, see MDP::memory_bytes()
+    size_t model_bytes = 0;
+};
+
+
 class PrismParser {
 
     // map each state to its transitions, later build matrix
@@ -149,6 +174,8 @@ class PrismParser {
     // how many dimensions of reward are currently loaded 
     size_t reward_dimension = 0;
 
+    ParseStats stats;
+
     // line and iterators inside
     std::string line;
     std::string::const_iterator curr, end;
@@ -203,6 +230,13 @@ public:
     MDP< double > parse_model( const std::string &transition_files,
                                const std::vector< std::string > &reward_files,
                                size_t initial_state );
+
+    // approximate memory held by all triplet maps, in bytes
+    size_t memory_bytes() const;
+
+    const ParseStats &get_parse_stats() const {
+        return stats;
+    }
 };
 
 
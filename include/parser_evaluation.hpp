@@ -12,11 +12,15 @@
 void eval_parser( size_t n_times ){
 
     std::ofstream data( "../out/parsing_time.csv" );
+    data << "Benchmark name;time mean;time variance;triplets kB;model kB;peak rss kB\n";
     PrismParser parser;
     
     std::vector< std::string > names = { "uav", "taskgraph", "teamform", "taskgraph2" };
     std::vector< std::vector< double > > results = { {}, {}, {}, {} };
 
+    // memory statistics of the last parse of each model
+    std::vector< ParseStats > memory( 4 );
+
     for ( size_t i = 0; i < n_times; i++ ) {
 
         auto start_time = std::chrono::steady_clock::now();
@@ -32,6 +36,7 @@ void eval_parser( size_t n_times ){
         auto finish_time = std::chrono::steady_clock::now();
         std::chrono::duration< double > exec_time = finish_time - start_time;
         results[0].push_back( exec_time.count() );
+        memory[0] = parser.get_parse_stats();
 
         auto ptaskgraph5 = parser.parse_model( "../benchmarks/taskgraph/taskgraph5.tra",
                 {
@@ -43,6 +48,7 @@ void eval_parser( size_t n_times ){
         finish_time = std::chrono::steady_clock::now();
         exec_time = finish_time - start_time;
         results[1].push_back( exec_time.count() );
+        memory[1] = parser.get_parse_stats();
         
         auto teamform3 = parser.parse_model( "../benchmarks/teamform/teamform3.tra",
                                              {
@@ -52,6 +58,7 @@ void eval_parser( size_t n_times ){
         finish_time = std::chrono::steady_clock::now();
         exec_time = finish_time - start_time;
         results[2].push_back( exec_time.count() );
+        memory[2] = parser.get_parse_stats();
         
         auto taskgraph30 = parser.parse_model( "../benchmarks/taskgraph2/taskgraph30.tra",
                           {
@@ -62,6 +69,7 @@ void eval_parser( size_t n_times ){
         finish_time = std::chrono::steady_clock::now();
         exec_time = finish_time - start_time;
         results[3].push_back( exec_time.count() );
+        memory[3] = parser.get_parse_stats();
     }
 
     for ( size_t i = 0; i < 4; i++ ) {
@@ -78,6 +86,7 @@ void eval_parser( size_t n_times ){
             std += std::pow( val - mean , 2) / ( size - 1 );
         }
 
-        data << mean << ";" << std;
+        data << mean << ";" << std << ";" << memory[i].triplet_bytes / 1024 << ";";
+        data << memory[i].model_bytes / 1024 << ";" << memory[i].build_peak_rss << "\n";
     }
 }
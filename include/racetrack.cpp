@@ -7,11 +7,7 @@ bool Racetrack::vehicle_collides( const VehicleState& state ) const{
         return true;
     }
 
-    if ( collision_states.find( state.position ) != collision_states.end() ){
-        return true;
-    }
-
-    return false;
+    return grid.is( state.position, CELL_WALL );
 }
 
 VehicleState Racetrack::get_current_state() const {
@@ -19,37 +15,48 @@ VehicleState Racetrack::get_current_state() const {
 }
 
 
+VehicleState Racetrack::successor( const VehicleState &pos, const std::pair< int, int > &action ) const {
+    VehicleState succ( pos );
+    succ.add_velocity( action );
+    succ.move();
+
+    return vehicle_collides( succ ) ? initial_state : succ;
+}
+
+
+size_t Racetrack::velocity_index( const std::pair< int, int > &velocity ) {
+    return ( velocity.first + max_velocity ) * ( 2 * max_velocity + 1 ) + ( velocity.second + max_velocity );
+}
+
+
+size_t Racetrack::action_index( const std::pair< int, int > &action ) {
+    return ( action.first + 1 ) * 3 + ( action.second + 1 );
+}
+
+
 std::map< VehicleState, double > Racetrack::get_transition( const VehicleState &pos, 
                                                             const std::pair< int, int > &action ) const {
 
-    VehicleState succ( pos ), succ_slip( pos );
-
     // transition with p=1 to terminal state if race is finished
-    if ( goal_states.find( pos.position ) != goal_states.end() || pos == terminal_state ) {
+    if ( grid.is( pos.position, CELL_GOAL ) || pos == terminal_state ) {
         return { { terminal_state, 1.0 } };
     }
 
-    succ.add_velocity( action );
-    succ.move();
-    succ_slip.move();
-
     std::map< VehicleState, double > result;
 
-    // handle possible slips
-    if ( vehicle_collides( succ ) ){
-        result[ initial_state ] += 1 - slip_prob;
-    }
-    else {
-        result[ succ ] += 1 - slip_prob;
-    }
+    if ( !transition_table.empty() ) {
+        VehicleCodec codec = state_codec();
+        const auto &[ succ, succ_slip ] = transition_table[ codec.encode( pos ) * 9 + action_index( action ) ];
 
-    if ( vehicle_collides( succ_slip ) ){
-        result[ initial_state ] += slip_prob;
-    }
-    else{
-        result[ succ_slip ] += slip_prob;
+        result[ codec.decode( succ ) ] += 1 - slip_prob;
+        result[ codec.decode( succ_slip ) ] += slip_prob;
+        return result;
     }
 
+    // handle possible slips, the velocity change does not take effect
+    result[ successor( pos, action ) ] += 1 - slip_prob;
+    result[ successor( pos, { 0, 0 } ) ] += slip_prob;
+
     return result;
 }
 
@@ -57,7 +64,7 @@ Racetrack::reward_t Racetrack::get_reward( const VehicleState &pos,
                                            const std::pair< int, int > &action ) {
 
     // if terminal state / moving to terminal state, don't lose fuel anymore
-    if ( ( goal_states.find( pos.position ) != goal_states.end() ) || ( pos == terminal_state ) ){
+    if ( grid.is( pos.position, CELL_GOAL ) || ( pos == terminal_state ) ){
         return { 0, 0 };
     }
 
@@ -82,7 +89,7 @@ std::pair< Racetrack::reward_t, Racetrack::reward_t > Racetrack::reward_range()
 std::vector< Racetrack::action_t > Racetrack::get_actions( const VehicleState& pos ) const {
     
     // make all goal states transition to end with placeholder action
-    if ( goal_states.find( pos.position ) != goal_states.end() ){
+    if ( grid.is( pos.position, CELL_GOAL ) ){
         return { { 0, 0 } };
     }
 
@@ -91,19 +98,7 @@ std::vector< Racetrack::action_t > Racetrack::get_actions( const VehicleState& p
         return { { 0, 0 } };
     }
 
-    std::vector< action_t > res;
-
-    for ( int delta_x : { -1, 0, 1 } ) {
-        for ( int delta_y : { -1, 0, 1 } ) {
-            auto [ x, y ] = pos.velocity;
-
-            // speed cannot exceed 5 in either component
-            if ( ( std::abs( x + delta_x ) <= 5 ) && ( std::abs( y + delta_y ) <= 5 ) )
-                res.emplace_back( delta_x, delta_y );
-        }
-    }
-
-    return res;
+    return action_lists[ velocity_index( pos.velocity ) ];
 }
 
 
@@ -114,7 +109,7 @@ Racetrack::Observation Racetrack::step( const Racetrack::action_t &dir )  {
     VehicleState next_state = gen.sample_distribution( get_transition( current_state, dir ) );
     
     current_state = next_state;
-    return { next_state, reward, goal_states.find( next_state.position ) != goal_states.end() };
+    return { next_state, reward, grid.is( next_state.position, CELL_GOAL ) };
 }
 
 
@@ -132,10 +127,48 @@ std::string Racetrack::name() const {
     return "Racetrack" + std::to_string(height) + "x" + std::to_string(width) + std::to_string( slip_prob );
 }
 
+void Racetrack::precompute_transitions() {
+
+    VehicleCodec codec = state_codec();
+    transition_table.assign( codec.size() * 9, { 0, 0 } );
+
+    // the terminal state ( last id ) is handled in get_transition()
+    for ( size_t id = 0; id + 1 < codec.size(); id++ ) {
+        VehicleState pos = codec.decode( id );
+
+        for ( int delta_x : { -1, 0, 1 } ) {
+            for ( int delta_y : { -1, 0, 1 } ) {
+                auto &entry = transition_table[ id * 9 + action_index( { delta_x, delta_y } ) ];
+
+                // velocities out of range are not enabled, see get_actions()
+                VehicleState succ( pos );
+                succ.add_velocity( { delta_x, delta_y } );
+                if ( ( std::abs( succ.velocity.first ) > max_velocity ) || ( std::abs( succ.velocity.second ) > max_velocity ) ) {
+                    entry = { static_cast< uint32_t >( id ), static_cast< uint32_t >( id ) };
+                    continue;
+                }
+
+                entry = { static_cast< uint32_t >( codec.encode( successor( pos, { delta_x, delta_y } ) ) ),
+                          static_cast< uint32_t >( codec.encode( successor( pos, { 0, 0 } ) ) ) };
+            }
+        }
+    }
+}
+
+
+bool Racetrack::has_transition_table() const {
+    return !transition_table.empty();
+}
+
+
+VehicleCodec Racetrack::state_codec() const {
+    return VehicleCodec( height, width, terminal_state );
+}
+
 void Racetrack::set_hyperparams( double prob ) {
     slip_prob = prob;
 }
-void Racetrack::from_file( const std::string &filename ){
+void Racetrack::from_file( const std::string &filename, bool precompute ){
 
     std::ifstream input_str( filename );
 
@@ -201,8 +234,16 @@ void Racetrack::from_file( const std::string &filename ){
 
     height = h;
     width = w;
-    collision_states = collisions;
-    goal_states = goals;
+
+    grid = GridMap( height, width );
+    grid.mark_all( collisions, CELL_WALL );
+    grid.mark_all( goals, CELL_GOAL );
+
+    // the table of the previous track is invalid
+    transition_table.clear();
+    if ( precompute ) {
+        precompute_transitions();
+    }
 
 }
 
@@ -212,7 +253,23 @@ Racetrack::Racetrack() : current_state()
                        , terminal_state( Coordinates( -1, -1 ), { 0, 0 } )
                        , height( 1 )
                        , width( 4 )
-                       , collision_states()
-                       , goal_states( { Coordinates( 3, 0 ) } )
-                       , gen() {}
+                       , grid( 1, 4 )
+                       , gen()
+                       , action_lists( ( 2 * max_velocity + 1 ) * ( 2 * max_velocity + 1 ) ) {
+    grid.mark( Coordinates( 3, 0 ), CELL_GOAL );
+
+    for ( int x = -max_velocity; x <= max_velocity; x++ ) {
+        for ( int y = -max_velocity; y <= max_velocity; y++ ) {
+            auto &actions = action_lists[ velocity_index( { x, y } ) ];
+
+            for ( int delta_x : { -1, 0, 1 } ) {
+                for ( int delta_y : { -1, 0, 1 } ) {
+                    // speed cannot exceed max_velocity in either component
+                    if ( ( std::abs( x + delta_x ) <= max_velocity ) && ( std::abs( y + delta_y ) <= max_velocity ) )
+                        actions.emplace_back( delta_x, delta_y );
+                }
+            }
+        }
+    }
+}
 
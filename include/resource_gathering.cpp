@@ -11,16 +11,18 @@ std::map< ResourceState, double > ResourceGathering::get_transition( const Resou
     ResourceState successor( pos );
     successor.position += dir_to_vec( dir );
 
-    if ( gold.find( successor.position ) != gold.end() ) {
+    uint8_t cell = grid.get( successor.position );
+
+    if ( cell & CELL_GOLD ) {
         successor.flags[0] = true;
     }
 
-    if ( gems.find( successor.position ) != gems.end() ) {
+    if ( cell & CELL_GEM ) {
         successor.flags[1] = true;
     }
 
     // return to start with probability prob_of_attack
-    if ( ( attackers.find( successor.position ) != attackers.end() ) &&  
+    if ( ( cell & CELL_ATTACKER ) &&  
            !approx_zero( prob_of_attack ) ) {
         return { { initial_state, prob_of_attack }, 
                  { successor, 1 - prob_of_attack } };
@@ -101,13 +103,17 @@ std::string ResourceGathering::name() const {
     return "Resource Gathering - " + std::to_string(prob_of_attack);
 }
 
+ResourceCodec ResourceGathering::state_codec() const {
+    return ResourceCodec( height, width );
+}
+
 void ResourceGathering::set_hyperparams( double prob ) {
     prob_of_attack = prob;
 }
 
 
 ResourceGathering::ResourceGathering() : height( 5 ), width( 5 ),
-    gold(), gems(), attackers(), current_state(), initial_state() {
+    gold(), gems(), attackers(), grid( 5, 5 ), current_state(), initial_state() {
 }
 
 ResourceGathering::ResourceGathering( size_t height, size_t width, 
@@ -116,7 +122,12 @@ ResourceGathering::ResourceGathering( size_t height, size_t width,
                                       const std::set< Coordinates > &gems,
                                       const std::set< Coordinates > &attackers ) :
                                       height( height ), width ( width ),
-                                      gold( gold ), gems( gems ), attackers( attackers ) { 
+                                      gold( gold ), gems( gems ), attackers( attackers ),
+                                      grid( height, width ) { 
+    grid.mark_all( gold, CELL_GOLD );
+    grid.mark_all( gems, CELL_GEM );
+    grid.mark_all( attackers, CELL_ATTACKER );
+
     initial_state = ResourceState( initial_pos, { false, false } );
     current_state = initial_state;
 }
@@ -0,0 +1,190 @@
+# pragma once
+
+#include "models/env_wrapper.hpp"
+#include "models/generator.hpp"
+#include "models/mdp.hpp"
+
+#include "parser.hpp"
+
+#include "solvers/brtdp.hpp"
+#include "solvers/chvi.hpp"
+#include "solvers/config.hpp"
+#include "solvers/weighted_sum.hpp"
+
+#include "utils/memory.hpp"
+
+#include <chrono>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <string>
+#include <vector>
+
+/*
+ * scaling benchmark on synthetic MDPs ( see models/generator.hpp ), for each
+ * model size a model is generated from the same settings and solved by every
+ * engine, one row per ( size, engine ) is written to filename:
+ *
+ *  states;transitions;engine;generation time;solve time;updates;converged;peak rss
+ *
+ * updates are state-action backups for every engine, although a backup of
+ * the weighted sum engine is a scalar one, while BRTDP and CHVI back up curves.
+ * the peak resident set size ( kB ) is reset before each solve where supported,
+ * out/visualization/scaling.p plots the results
+ */
+
+struct ScalingRow {
+    std::string engine;
+    double solve_time;
+    size_t updates;
+    bool converged;
+    size_t peak_rss;
+};
+
+
+inline ScalingRow measure_engine( const std::string &engine,
+                                  const std::function< VerificationResult< double >() > &solve ) {
+    reset_peak_rss();
+    auto res = solve();
+
+    if ( !res.converged ) {
+        std::cout << engine << " did not converge, continuing.\n";
+    }
+
+    return ScalingRow{ engine, res.time_to_convergence, res.update_number, res.converged, peak_rss_kb() };
+}
+
+
+// solves mdp by every engine
+inline std::vector< ScalingRow > solve_all_engines( MDP< double > &mdp,
+                                                    const ExplorationSettings< double > &config ) {
+
+    // dispatched statically to the model, see EnvironmentWrapper
+    using wrapper_t = EnvironmentWrapper< size_t, size_t, std::vector< double >, double, MDP< double > >;
+    std::vector< ScalingRow > rows;
+
+    rows.push_back( measure_engine( "brtdp", [ & ]{
+        BRTDPSolver< size_t, size_t, double, MDP< double > > brtdp( wrapper_t( &mdp ), config );
+        return brtdp.solve();
+    }));
+
+    rows.push_back( measure_engine( "chvi", [ & ]{
+        CHVIExactSolver< size_t, size_t, double, MDP< double > > chvi( wrapper_t( &mdp ), config );
+        return chvi.solve();
+    }));
+
+    rows.push_back( measure_engine( "weighted sum", [ & ]{
+        WeightedSumSolver< double > ws( mdp, config );
+        return ws.solve();
+    }));
+
+    return rows;
+}
+
+
+inline void eval_scaling( const std::vector< size_t > &sizes,
+                          GeneratorSettings settings,
+                          const ExplorationSettings< double > &config,
+                          const std::string &filename="../out/scaling.csv" ) {
+
+    std::ofstream out( filename );
+    out << "states;transitions;engine;generation time;solve time;updates;converged;peak rss\n";
+
+    for ( size_t size : sizes ) {
+        settings.states = size;
+
+        auto start_time = std::chrono::steady_clock::now();
+        MDP< double > mdp = generate_mdp( settings );
+        std::chrono::duration< double > generation_time = std::chrono::steady_clock::now() - start_time;
+
+        std::cout << "Generated model with " << mdp.num_states() << " states and "
+                  << mdp.num_transitions() << " transitions.\n";
+
+        for ( const auto &row : solve_all_engines( mdp, config ) ) {
+            out << mdp.num_states() << ";" << mdp.num_transitions() << ";" << row.engine << ";";
+            out << generation_time.count() << ";" << row.solve_time << ";" << row.updates << ";";
+            out << row.converged << ";" << row.peak_rss << std::endl;
+        }
+    }
+}
+
+
+// one family of shipped PRISM models, all sizes share the reward structure
+struct PrismFamily {
+    std::string name;
+    std::string directory;
+    std::vector< std::string > sizes;
+    std::vector< OptimizationDirection > directions;
+};
+
+
+/* scaling over all model sizes shipped in benchmarks/, each model is parsed,
+ * built and solved by every engine, sizes whose files are missing are skipped.
+ * one row per ( model, engine ) is written to filename:
+ *
+ *  model;states;transitions;parse time;parse peak rss;engine;solve time;updates;converged;solve peak rss
+ *
+ * with updates counted as in eval_scaling
+ */
+inline void eval_prism_scaling( const std::string &filename="../out/prism_scaling.csv" ) {
+
+    std::vector< PrismFamily > families = {
+        { "uav", "../benchmarks/uav/", { "5", "10", "20" },
+          { OptimizationDirection::MINIMIZE, OptimizationDirection::MINIMIZE } },
+        { "taskgraph", "../benchmarks/taskgraph/", { "5", "10" },
+          { OptimizationDirection::MINIMIZE, OptimizationDirection::MINIMIZE } },
+        { "taskgraph", "../benchmarks/taskgraph2/", { "30", "50" },
+          { OptimizationDirection::MINIMIZE, OptimizationDirection::MINIMIZE } },
+        { "teamform", "../benchmarks/teamform/", { "3" },
+          { OptimizationDirection::MAXIMIZE, OptimizationDirection::MAXIMIZE } },
+    };
+
+    // same settings as eval_uav
+    ExplorationSettings< double > config;
+    config.trace = false;
+    config.max_depth = 0;
+    config.max_episodes = 0;
+    config.max_seconds = 300;
+    config.precision = 0.01;
+    config.depth_constant = 50;
+    config.discount_param = 0.99;
+
+    std::ofstream out( filename );
+    out << "model;states;transitions;parse time;parse peak rss;engine;solve time;updates;converged;solve peak rss\n";
+
+    PrismParser parser;
+
+    for ( const auto &family : families ) {
+        for ( const auto &size : family.sizes ) {
+
+            std::string model = family.name + size;
+            std::string prefix = family.directory + model;
+            std::vector< std::string > files = { prefix + ".tra", prefix + "1.trew", prefix + "2.trew" };
+
+            bool missing = false;
+            for ( const auto &file : files ) {
+                missing |= !std::ifstream( file ).good();
+            }
+
+            if ( missing ) {
+                std::cout << "Skipping " << model << ", some of its files are missing.\n";
+                continue;
+            }
+
+            reset_peak_rss();
+            auto start_time = std::chrono::steady_clock::now();
+            MDP< double > mdp = parser.parse_model( files[0], { files[1], files[2] }, 0 );
+            std::chrono::duration< double > parse_time = std::chrono::steady_clock::now() - start_time;
+            size_t parse_rss = peak_rss_kb();
+
+            config.directions = family.directions;
+            config.filename = model;
+
+            for ( const auto &row : solve_all_engines( mdp, config ) ) {
+                out << model << ";" << mdp.num_states() << ";" << mdp.num_transitions() << ";";
+                out << parse_time.count() << ";" << parse_rss << ";" << row.engine << ";";
+                out << row.solve_time << ";" << row.updates << ";" << row.converged << ";" << row.peak_rss << std::endl;
+            }
+        }
+    }
+}
@@ -18,6 +18,21 @@ void DeepSeaTreasure::initialize_state( Coordinates pos ) {
 }
 
 
+void DeepSeaTreasure::build_grid() {
+    grid = GridMap( height, width );
+    treasure_values.assign( grid.size(), 0 );
+
+    grid.mark_all( inacessible_squares, CELL_WALL );
+
+    for ( const auto &[ pos, value ] : treasures ) {
+        if ( grid.in_bounds( pos ) ) {
+            grid.mark( pos, CELL_TREASURE );
+            treasure_values[ grid.index( pos ) ] = value;
+        }
+    }
+}
+
+
 bool DeepSeaTreasure::terminated( const TreasureState& s ){
     return s == terminal_state;
 }
@@ -41,7 +56,7 @@ std::map< TreasureState, double > DeepSeaTreasure::get_transition( const Treasur
     for ( const auto &a : actions ) {
         TreasureState copy(s);
         copy.position += dir_to_vec( a );
-        if ( treasures.find( copy.position ) != treasures.end() ) {
+        if ( grid.is( copy.position, CELL_TREASURE ) ) {
             copy.treasure_collected = true;
         }
 
@@ -82,13 +97,8 @@ DeepSeaTreasure::reward_t DeepSeaTreasure::get_reward( const TreasureState &s, c
 
     // weigh state rewards of sucessors 
     for ( const auto &[ successor, prob ] : transition ) {
-        auto it = treasures.begin();
-        for ( size_t i = 0; i < treasures.size(); i++ ) {
-            // if visiting treasure for the first time
-            if ( ( it->first == successor.position ) && ( !s.treasure_collected ) ) {
-                treasure += it->second * prob;
-            }
-            it++;
+        if ( grid.is( successor.position, CELL_TREASURE ) ) {
+            treasure += treasure_values[ grid.index( successor.position ) ] * prob;
         }
     }
 
@@ -120,7 +130,7 @@ std::vector< Direction > DeepSeaTreasure::get_actions( const TreasureState &s )
     std::vector< Direction > result;
     for ( auto dir : { Direction::UP, Direction::DOWN, Direction::LEFT, Direction::RIGHT } ) {
 
-        if ( inacessible_squares.find( s.position + dir_to_vec( dir ) ) != inacessible_squares.end() ) {
+        if ( grid.is( s.position + dir_to_vec( dir ), CELL_WALL ) ) {
             continue;
         }
         if ( !collides( s.position, dir, height, width ) ){
@@ -183,6 +193,11 @@ std::set< Coordinates > DeepSeaTreasure::get_inaccessible() const {
 }
 
 
+TreasureCodec DeepSeaTreasure::state_codec() const {
+    return TreasureCodec( height, width, terminal_state );
+}
+
+
 void DeepSeaTreasure::set_hyperparams( double fuel, double noise_new ) {
     fuel_per_turn = fuel;
     noise = noise_new;
@@ -246,6 +261,7 @@ void DeepSeaTreasure::from_file( const std::string &filename ) {
     width = w;
     inacessible_squares = blocked;
     treasures = treasures_new;
+    build_grid();
 
     // just use 0,0 as starting implicitly for now 
     initialize_state( Coordinates(0, 0) );
@@ -259,7 +275,10 @@ DeepSeaTreasure::DeepSeaTreasure( size_t height, size_t width, Coordinates initi
                         current_state(),
                         initial_state(),
                         treasures( treasures ),
-                        inacessible_squares( inacessible_squares ) { initialize_state( initial_pos ); }
+                        inacessible_squares( inacessible_squares ) { 
+    build_grid();
+    initialize_state( initial_pos ); 
+}
 
 // default init position to ( 0, 0 )
 DeepSeaTreasure::DeepSeaTreasure() : height(0),
@@ -284,6 +303,7 @@ DeepSeaTreasure::DeepSeaTreasure( const DeepSeaTreasure &other ) {
     inacessible_squares = inaccess;
     current_state = current;
     initial_state = initial;
+    build_grid();
 
     terminal_state = TreasureState();
     terminal_state.position = Coordinates( -1, -1 );
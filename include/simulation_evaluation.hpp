@@ -0,0 +1,68 @@
+# pragma once
+
+#include "benchmarks/frozen_lake.hpp"
+#include "benchmarks/racetrack.hpp"
+#include "benchmarks/sea_treasure.hpp"
+
+#include "models/batch_simulator.hpp"
+#include "models/mdp.hpp"
+
+#include "parser.hpp"
+
+#include <fstream>
+#include <iostream>
+#include <string>
+
+/*
+ * throughput of the batched simulation ( see models/batch_simulator.hpp ),
+ * a uniformly random policy is simulated on several benchmarks, one row per
+ * benchmark is written to filename:
+ *
+ *  benchmark;lanes;horizon;threads;steps;time;steps per second;mean return 1;mean return 2
+ */
+
+template < typename env_t >
+void eval_simulation_throughput( std::ofstream &out, const std::string &name,
+                                 const env_t &env, const BatchSettings &settings ) {
+
+    BatchSimulator< env_t > simulator( env, settings );
+    UniformPolicy< env_t > policy;
+
+    BatchResult res = simulator.run( policy );
+
+    std::cout << name << ": " << res.steps << " steps in " << res.seconds << " s, "
+              << res.steps_per_second() << " steps per second.\n";
+
+    out << name << ";" << res.lanes << ";" << settings.horizon << ";" << simulator.num_threads() << ";";
+    out << res.steps << ";" << res.seconds << ";" << res.steps_per_second() << ";";
+    out << res.mean_return( 0 ) << ";" << res.mean_return( 1 ) << std::endl;
+}
+
+
+inline void eval_simulation( size_t lanes=4096, size_t horizon=200,
+                             const std::string &filename="../out/simulation.csv" ) {
+
+    BatchSettings settings;
+    settings.lanes = lanes;
+    settings.horizon = horizon;
+    settings.seed = 1;
+
+    std::ofstream out( filename );
+    out << "benchmark;lanes;horizon;threads;steps;time;steps per second;mean return 1;mean return 2\n";
+
+    PrismParser parser;
+    MDP< double > uav = parser.parse_model( "../benchmarks/uav/uav5.tra",
+                                            { "../benchmarks/uav/uav51.trew", "../benchmarks/uav/uav52.trew" }, 0 );
+    eval_simulation_throughput( out, "uav5", uav, settings );
+
+    Racetrack racetrack;
+    racetrack.from_file( "../benchmarks/racetracks/racetrack-hard.track", true );
+    eval_simulation_throughput( out, "racetrack-hard", racetrack, settings );
+
+    DeepSeaTreasure dst;
+    dst.from_file( "../benchmarks/treasures/treasure-concave.txt" );
+    eval_simulation_throughput( out, "treasure-concave", dst, settings );
+
+    FrozenLake lake;
+    eval_simulation_throughput( out, "frozenlake", lake, settings );
+}
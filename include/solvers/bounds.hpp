@@ -1,5 +1,6 @@
 # pragma once
 #include "geometry/polygon.hpp"
+#include "utils/profiling.hpp"
 
 
 
@@ -27,7 +28,11 @@ public:
 
     Bounds( const Bounds< value_t > &other ) : lower_bound( other.lower() )
                                              , upper_bound( other.upper() )
-                                             , hausdorff_valid( other.is_hausdorff_valid() ){}
+                                             , hausdorff_valid( other.hausdorff_valid )
+                                             , hausdorff_dist( other.hausdorff_dist )
+                                             , furthest_points( other.furthest_points ){}
+
+    Bounds &operator=( const Bounds< value_t > &other ) = default;
 
     Bounds ( const std::vector< std::vector< value_t > > &lower_pts, 
              const std::vector< std::vector< value_t > >&upper_pts ) : lower_bound( lower_pts ),
@@ -82,9 +87,49 @@ public:
         lower_bound.downward_closure( pt );
     }
 
+    bool equals( const Bounds< value_t > &other, value_t eps ) const {
+        return lower_bound.equals( other.lower(), eps ) && upper_bound.equals( other.upper(), eps );
+    }
+
     value_t hypervolume( const Point< value_t > &ref_point ) const {
         return upper_bound.hypervolume( ref_point );
     }
+
+    /* range of the best achievable weighted sum of objectives, the support
+     * of the lower and of the upper curve, see Polygon::support() */
+    std::pair< value_t, value_t > support( const std::vector< value_t > &weights ) const {
+        return { lower_bound.support( weights ), upper_bound.support( weights ) };
+    }
+
+    // support() of many weight vectors
+    std::vector< std::pair< value_t, value_t > > supports( const std::vector< std::vector< value_t > > &weights ) const {
+        std::vector< value_t > low = lower_bound.supports( weights ), upp = upper_bound.supports( weights );
+
+        std::vector< std::pair< value_t, value_t > > res;
+        res.reserve( weights.size() );
+        for ( size_t q = 0; q < weights.size(); q++ ) {
+            res.emplace_back( low[q], upp[q] );
+        }
+        return res;
+    }
+
+    // closest point to target known to be achievable, i.e. in the lower curve
+    Point< value_t > closest_achievable( const Point< value_t > &target ) const {
+        return lower_bound.closest_achievable( target );
+    }
+
+    // heap memory held by both curves and the cached furthest points, in bytes
+    size_t memory_bytes() const {
+        size_t bytes = lower_bound.memory_bytes() + upper_bound.memory_bytes()
+                     + furthest_points.capacity() * sizeof( Point< value_t > );
+
+        for ( const auto &p : furthest_points ) {
+            bytes += p.capacity() * sizeof( value_t );
+        }
+
+        return bytes;
+    }
+
     /* 
      * methods for distance calculations / caching them 
      */ 
@@ -96,6 +141,7 @@ public:
     // i.e. facets and downward closure intiialzied
     value_t hausdorff_distance(){
         if ( !hausdorff_valid ) {
+            PROFILE_SCOPE( ProfilePhase::Hausdorff );
             auto res = lower_bound.hausdorff_distance( upper_bound );
             
             hausdorff_dist = res.first;
@@ -2,19 +2,27 @@
 #include <algorithm>
 #include <stack> 
 #include "models/env_wrapper.hpp"
+#include "solvers/checkpoint.hpp"
 #include "solvers/config.hpp"
+#include "solvers/scheduler.hpp"
 #include "utils/eigen_types.hpp"
+#include "utils/memory.hpp"
+#include "utils/metrics.hpp"
+#include "utils/profiling.hpp"
 #include "utils/prng.hpp"
 
 
-template < typename state_t, typename action_t, typename value_t >
+/* env_t selects the environment calls are dispatched to, see
+ * EnvironmentWrapper, concrete environments avoid the virtual interface */
+template < typename state_t, typename action_t, typename value_t,
+           typename env_t = Environment< state_t, action_t, std::vector< value_t > > >
 class BRTDPSolver{
 
     /* 
      * TYPEDEFS
      */
 
-    using EnvironmentHandle = EnvironmentWrapper< state_t, action_t, std::vector< value_t >, value_t >;
+    using EnvironmentHandle = EnvironmentWrapper< state_t, action_t, std::vector< value_t >, value_t, env_t >;
     using ExplorationConfig = ExplorationSettings< value_t >;
     // implicitly starts from inital state s'
     using TrajectoryStack = std::stack< std::pair< action_t, state_t > >;
@@ -28,6 +36,16 @@ class BRTDPSolver{
     // prng for selecting actions/successors
     PRNG gen;
 
+    // progress on the starting state, see config.metrics_interval
+    MetricsRecorder< value_t > metrics;
+    MemoryTracker memory;
+
+    // starting state of the last call of solve()
+    state_t starting_state;
+
+    // see config.checkpoint_interval
+    Checkpointer< state_t, action_t, value_t > checkpoints;
+
     /*
      * ACTION HEURISTICS 
      */
@@ -41,7 +59,7 @@ class BRTDPSolver{
 
         std::vector< Point< value_t > > &nondominated = env.get_state_bound( s ).upper().get_vertices();
 
-        std::set< action_t > pareto_actions;
+        std::vector< action_t > pareto_actions;
 
         for ( const action_t &a : avail_actions ) {
             std::vector< Point< value_t > > &sa_points = env.get_state_action_bound( s, a ).upper().get_vertices();
@@ -56,7 +74,7 @@ class BRTDPSolver{
                                          pt, 
                                          []( const auto &x, const auto &y ){ return x[0] > y[0]; }) )  
                 {
-                    pareto_actions.insert( a );
+                    pareto_actions.push_back( a );
                     opt = true;
                 }
 
@@ -101,7 +119,7 @@ class BRTDPSolver{
 
         std::vector< Point< value_t > > furthest_pts = env.get_state_bound( s ).get_furthest_points();
 
-        std::set< action_t > maximizing_actions;
+        std::vector< action_t > maximizing_actions;
 
         for ( const action_t &a : avail_actions ) {
             std::vector< Point< value_t > > &sa_points = env.get_state_action_bound( s, a ).upper().get_vertices();
@@ -114,7 +132,7 @@ class BRTDPSolver{
                                          pt, 
                                          []( const auto &x, const auto &y ){ return x[0] > y[0]; }) )  
                 {
-                    maximizing_actions.insert( a );
+                    maximizing_actions.push_back( a );
                     opt = true;
                 }
 
@@ -133,6 +151,7 @@ class BRTDPSolver{
      * helper function to get differences of bounds for a transition map
      */
     std::vector< value_t > get_successor_diffs( const std::map< state_t , double > &transition ){
+        PROFILE_SCOPE( ProfilePhase::SuccessorDiffs );
         std::vector< value_t > diff_values;
         for ( const auto &[ s, prob ] : transition ) {
             Bounds< value_t > &bound = env.get_state_bound( s );
@@ -145,6 +164,8 @@ class BRTDPSolver{
     // picks action from avail actions based on specified heuristic
     action_t action_selection( const state_t &s, const std::vector< action_t > &avail_actions ) {
 
+        PROFILE_SCOPE( ProfilePhase::ActionSelection );
+
         if ( config.action_heuristic == ActionSelectionHeuristic::Pareto ) {
             return pareto_action( s, avail_actions );
         }
@@ -162,13 +183,14 @@ class BRTDPSolver{
      * samples an MDP trajectory using specified action/successor heuristics
      * and precision, initializing newly encountered state action bounds
      */
-    TrajectoryStack sample_trajectory() {
+    TrajectoryStack sample_trajectory( size_t episode ) {
         
         std::stack< std::pair< action_t, state_t > > trajectory;
 
         value_t discount_pow = config.discount_param;
 
-        auto [ state, _ , terminated ] = env.reset( 0, false );
+        // each trajectory reseeds the environment from its own seed
+        auto [ state, _ , terminated ] = env.reset( derive_seed( config.seed, SeedStream::Environment, episode + 1 ), false );
         terminated = false;
 
         size_t iter = 0;
@@ -178,8 +200,8 @@ class BRTDPSolver{
             // mark current state and initialize its default bounds
             env.discover( state );
 
-            // select action in this state
-            std::vector< action_t > actions = env.get_actions( state );
+            // select action in this state, out of those not eliminated yet
+            std::vector< action_t > actions = env.get_active_actions( state );
 
             action_t action = action_selection( state, actions );
 
@@ -223,6 +245,11 @@ class BRTDPSolver{
                 terminated = true;
             }
 
+            // bounds of frozen states cannot change, no need to go further
+            if ( env.is_frozen( state ) ) {
+                terminated = true;
+            }
+
             discount_pow *= config.discount_param;
             iter++;
 
@@ -232,6 +259,37 @@ class BRTDPSolver{
         
     }
 
+    /* the episode counter and generator are saved along with the bounds,
+     * the environment is reseeded from the episode in sample_trajectory() */
+    void write_checkpoint( size_t episode ) {
+        checkpoints.write( "brtdp", [ & ]( auto &out ){
+            out.write( static_cast< uint64_t >( episode ) );
+            out.write( gen.get_state() );
+            out.write( starting_state );
+            env.save_records( out );
+        });
+    }
+
+    // restores the bounds and the generator, returns the episode to continue from
+    size_t load_checkpoint( const std::string &filename ) {
+        BinaryReader in = Checkpointer< state_t, action_t, value_t >::open( filename, "brtdp" );
+
+        if constexpr ( Checkpointer< state_t, action_t, value_t >::supported ) {
+            size_t episode = in.template read< uint64_t >();
+            gen.set_state( in.template read< PRNG::State >() );
+
+            state_t state = in.template read< state_t >();
+            if ( ( state < starting_state ) || ( starting_state < state ) ) {
+                throw std::runtime_error( filename + " is a checkpoint of another starting state" );
+            }
+
+            env.load_records( in );
+            return episode;
+        }
+
+        return 0;
+    }
+
     /* executes BRTDP updates for the whole sampled trajectory */
     void update_along_trajectory( TrajectoryStack& trajectory, const state_t &starting_state ) {
         while ( !trajectory.empty() ) {
@@ -270,7 +328,7 @@ public:
      * trajectories during execution and number of discovered states at the end
      */
 
-    void load_environment( Environment< state_t, action_t, std::vector< value_t > > &new_env ) {
+    void load_environment( env_t &new_env ) {
         env = EnvironmentHandle( &new_env );
     }
 
@@ -279,6 +337,29 @@ public:
         config = _config;
     }
 
+    /* replaces the bounds by copies of those of another solver with the
+     * same states, e.g. solved with other parameters of the environment,
+     * used by the next solve() if config.warm_start is set */
+    void import_bounds( const EnvironmentHandle &other ) {
+        env.copy_records_from( other );
+    }
+
+    const EnvironmentHandle &get_environment() const {
+        return env;
+    }
+
+    /* scheduler achieving points of the lower bound of the starting state,
+     * extracted from the bounds left by the last call of solve(), see
+     * solvers/scheduler.hpp */
+    Scheduler< state_t, action_t, value_t > extract_scheduler() {
+        return Scheduler< state_t, action_t, value_t >( env, starting_state );
+    }
+
+    // samples recorded during the last call of solve()
+    const MetricsRecorder< value_t > &get_metrics() const {
+        return metrics;
+    }
+
 
     /* solves the loaded MDP, utilizing currently loaded config ( discount
      * parameters, precision, etc. )
@@ -288,25 +369,65 @@ public:
      * result pareto curve to filename-result.txt
      */
     VerificationResult< value_t > solve() {
+        return run( "" );
+    }
+
+    /* continues the run saved to filename by the checkpoints of solve(),
+     * with the same environment and config ( up to the limits of the run ),
+     * the episodes are counted from the checkpoint, the time from the call */
+    VerificationResult< value_t > resume( const std::string &filename ) {
+        return run( filename );
+    }
+
+private:
+
+    // solve() from scratch ( or warm started ) if checkpoint is empty
+    VerificationResult< value_t > run( const std::string &checkpoint ) {
 
         auto start_time = std::chrono::steady_clock::now();
+        reset_profile();
+        memory.start();
+
+        starting_state = std::get< 0 > ( env.reset( derive_seed( config.seed, SeedStream::Environment, 0 ), !config.warm_start ) );
 
-        state_t starting_state = std::get< 0 > ( env.reset( 0 ) );
+        unsigned solver_seed = derive_seed( config.seed, SeedStream::Solver, 0 );
+        if ( solver_seed == 0 ) {  gen.seed(); }
+        else                    {  gen.seed( solver_seed ); }
     
 
         // pass config to handler
         env.set_config( config );
+        env.precompute_initial_bounds();
+
+        size_t episode = 0;
+
+        // reuse the bounds of the previous call
+        if ( !checkpoint.empty() )    { episode = load_checkpoint( checkpoint ); }
+        else if ( config.warm_start ) { env.revalidate_bounds(); }
 
         // initialize starting state bound
         env.discover( starting_state );
         
         Bounds< value_t > start_bound = env.get_state_bound( starting_state );
+        memory.end_initialization();
+        checkpoints.start( config.checkpoint_file, config.checkpoint_interval );
 
-        size_t episode = 0;
+        // lower end of the bounds, reference point of the hypervolumes
+        Point< value_t > ref_point = env.get_initial_bound().first;
+
+        auto record_metrics = [ & ](){
+            std::chrono::duration< double > elapsed = std::chrono::steady_clock::now() - start_time;
+            metrics.record( { episode, elapsed.count(), start_bound.hausdorff_distance(),
+                              start_bound.lower().hypervolume( ref_point ),
+                              env.get_update_num(), env.num_states_explored() } );
+        };
+
+        metrics.reset( ( config.metrics_interval > 0 ) ? config.metrics_capacity : 0 );
+        if ( metrics.enabled() ) { record_metrics(); }
 
         while ( start_bound.hausdorff_distance() >= config.precision ) {
 
-            TrajectoryStack trajectory = sample_trajectory();
+            TrajectoryStack trajectory = sample_trajectory( episode );
             update_along_trajectory( trajectory, starting_state );
 
             if ( config.trace ){
@@ -318,6 +439,10 @@ public:
             start_bound = env.get_state_bound( starting_state );
 
             episode++;
+
+            if ( metrics.enabled() && ( episode % config.metrics_interval == 0 ) ) { record_metrics(); }
+            if ( checkpoints.due() ) { write_checkpoint( episode ); }
+
             // if max episodes is set to 0, no limit.
             if ( ( config.max_episodes > 0 ) && ( episode >= config.max_episodes ) )  { break; }
 
@@ -328,13 +453,30 @@ public:
 
         }
     
+        if ( metrics.enabled() ) {
+            // final state of the run, unless recorded in the last episode
+            if ( episode % config.metrics_interval != 0 ) { record_metrics(); }
+            metrics.write_csv( config.metrics_filename, config.filename, "brtdp", heuristic_name( config.action_heuristic ) );
+        }
+
+        // lets a warm started solve on the same model keep the bounds as they are
+        env.seal_records();
+
+        if ( checkpoints.enabled() ) {
+            write_checkpoint( episode );
+            checkpoints.finish();
+        }
+
         auto finish_time = std::chrono::steady_clock::now();
         std::chrono::duration< double > exec_time = finish_time - start_time;
         VerificationResult< value_t > res{ env.get_update_num() // num of updates
                                        , start_bound.hausdorff_distance() < config.precision // bool converged
                                        , start_bound 
                                        , exec_time.count()
-                                       , env.num_states_explored() }; // num of explored states
+                                       , env.num_states_explored() // num of explored states
+                                       , env.num_states_frozen() // num of frozen states
+                                       , collect_profile() // time spent in each phase
+                                       , memory.finish( env.bound_memory_bytes() ) };
                                         
         return res;
     }
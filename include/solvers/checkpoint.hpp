@@ -0,0 +1,129 @@
+# pragma once
+
+# include <chrono>
+# include <cstdint>
+# include <iostream>
+# include <stdexcept>
+# include <string>
+# include "utils/serialization.hpp"
+
+/*
+ * periodic binary checkpoints of a solver, see config.checkpoint_interval and
+ * the resume() methods of the solvers
+ *
+ * a checkpoint consists of a header ( magic number, format version, name of
+ * the solver and the sizes of the state, action and value types ), the
+ * counters and generator state of the solver and the records of its
+ * EnvironmentWrapper, see EnvironmentWrapper::save_records()
+ *
+ * the checkpoint is serialized by the solver thread, so that it is a
+ * consistent snapshot of the bounds, in chunks of chunk_size bytes, which are
+ * written to disk on a background thread meanwhile, so that the bounds are
+ * never held twice in memory. the file is replaced atomically once complete
+ * ( see AtomicFile ), so a run killed during the write keeps the previous
+ * checkpoint
+ */
+
+template < typename state_t, typename action_t, typename value_t >
+class Checkpointer {
+
+    static constexpr uint32_t magic = 0x50434f4d; // "MOCP"
+    static constexpr uint32_t version = 1;
+
+    // bytes handed to the background thread at once
+    static constexpr size_t chunk_size = 4 << 20;
+
+    std::string filename;
+    double interval = 0;
+    std::chrono::steady_clock::time_point last_write;
+
+    AsyncFileWriter writer;
+
+    static void report( bool success, const std::string &filename ) {
+        if ( !success ) {
+            std::cout << "error: writing checkpoint " << filename << " failed.\n";
+        }
+    }
+
+public:
+
+    // checkpoints need serializable states and actions, see utils/serialization.hpp
+    static constexpr bool supported = is_serializable_v< state_t > && is_serializable_v< action_t >;
+
+    // checkpoints every interval seconds ( 0 disables them ) into filename
+    void start( const std::string &_filename, double _interval ) {
+        filename = _filename;
+        interval = _interval;
+        last_write = std::chrono::steady_clock::now();
+
+        if ( enabled() && !supported ) {
+            std::cout << "checkpoints of this state / action type are unsupported, disabling them.\n";
+            interval = 0;
+        }
+    }
+
+    bool enabled() const {
+        return interval > 0;
+    }
+
+    bool due() const {
+        std::chrono::duration< double > elapsed = std::chrono::steady_clock::now() - last_write;
+        return enabled() && ( elapsed.count() >= interval );
+    }
+
+    /* serializes the header and then calls serialize( out ) with the
+     * BinaryWriter, the chunks are written in the background, the commit of
+     * the file as well */
+    template < typename serialize_t >
+    void write( const std::string &solver, serialize_t &&serialize ) {
+
+        if constexpr ( supported ) {
+            report( writer.open( filename ), filename );
+
+            BinaryWriter out( [ this ]( std::vector< char > &&chunk ){ writer.append( std::move( chunk ) ); }, chunk_size );
+            out.write( magic );
+            out.write( version );
+            out.write( solver );
+            out.write( static_cast< uint32_t >( sizeof( state_t ) ) );
+            out.write( static_cast< uint32_t >( sizeof( action_t ) ) );
+            out.write( static_cast< uint32_t >( sizeof( value_t ) ) );
+
+            serialize( out );
+            out.flush();
+
+            writer.commit();
+            last_write = std::chrono::steady_clock::now();
+        }
+    }
+
+    // waits for the last checkpoint to be written
+    void finish() {
+        report( writer.wait(), filename );
+    }
+
+    /* reads the checkpoint from filename and checks its header, the returned
+     * reader is positioned after it */
+    static BinaryReader open( const std::string &filename, const std::string &solver ) {
+
+        if constexpr ( !supported ) {
+            throw std::runtime_error( "checkpoints of this state / action type are unsupported" );
+        }
+
+        BinaryReader in( read_file( filename ) );
+
+        if ( ( in.read< uint32_t >() != magic ) || ( in.read< uint32_t >() != version ) ) {
+            throw std::runtime_error( filename + " is not a checkpoint of this version" );
+        }
+
+        if ( in.read< std::string >() != solver ) {
+            throw std::runtime_error( filename + " is not a checkpoint of " + solver );
+        }
+
+        if ( ( in.read< uint32_t >() != sizeof( state_t ) ) || ( in.read< uint32_t >() != sizeof( action_t ) ) ||
+             ( in.read< uint32_t >() != sizeof( value_t ) ) ) {
+            throw std::runtime_error( filename + " is a checkpoint of other state / action / value types" );
+        }
+
+        return in;
+    }
+};
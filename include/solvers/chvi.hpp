@@ -2,20 +2,65 @@
 
 # include <queue>
 # include "models/env_wrapper.hpp"
+# include "solvers/checkpoint.hpp"
 # include "solvers/config.hpp"
+# include "solvers/scheduler.hpp"
 # include "utils/eigen_types.hpp"
+# include "utils/memory.hpp"
+# include "utils/metrics.hpp"
+# include "utils/profiling.hpp"
 # include "utils/prng.hpp"
 
-template < typename state_t, typename action_t, typename value_t >
+/* env_t selects the environment calls are dispatched to, see
+ * EnvironmentWrapper, concrete environments avoid the virtual interface */
+template < typename state_t, typename action_t, typename value_t,
+           typename env_t = Environment< state_t, action_t, std::vector< value_t > > >
 class CHVIExactSolver{
 
-    using EnvironmentHandle = EnvironmentWrapper< state_t, action_t, std::vector< value_t >, value_t >;
+    using EnvironmentHandle = EnvironmentWrapper< state_t, action_t, std::vector< value_t >, value_t, env_t >;
     ExplorationSettings< value_t > config;
 
     EnvironmentHandle env;
 
     std::set< state_t > reachable_states;
 
+    // progress on the starting state, see config.metrics_interval
+    MetricsRecorder< value_t > metrics;
+    MemoryTracker memory;
+
+    // starting state of the last call of solve()
+    state_t starting_state;
+
+    // see config.checkpoint_interval
+    Checkpointer< state_t, action_t, value_t > checkpoints;
+
+    void write_checkpoint( size_t sweeps ) {
+        checkpoints.write( "chvi", [ & ]( auto &out ){
+            out.write( static_cast< uint64_t >( sweeps ) );
+            out.write( starting_state );
+            env.save_records( out );
+        });
+    }
+
+    // restores the bounds, returns the sweep to continue from
+    size_t load_checkpoint( const std::string &filename ) {
+        BinaryReader in = Checkpointer< state_t, action_t, value_t >::open( filename, "chvi" );
+
+        if constexpr ( Checkpointer< state_t, action_t, value_t >::supported ) {
+            size_t sweeps = in.template read< uint64_t >();
+
+            state_t state = in.template read< state_t >();
+            if ( ( state < starting_state ) || ( starting_state < state ) ) {
+                throw std::runtime_error( filename + " is a checkpoint of another starting state" );
+            }
+
+            env.load_records( in );
+            return sweeps;
+        }
+
+        return 0;
+    }
+
     // bfs to find all reachable states
     void set_reachable_states() {
         std::queue< state_t > q;
@@ -45,11 +90,16 @@ class CHVIExactSolver{
             std::cout << "CHVI - reachable states:\n";
 
             for ( const auto& state : reachable_states ) {
-                std::cout << state << "\n";
+                print_trace( std::cout, state );
+                std::cout << "\n";
                 for ( const auto act : env.get_actions( state ) ) {
-                    std::cout << "  Action " << act << ".\n";
+                    std::cout << "  Action ";
+                    print_trace( std::cout, act );
+                    std::cout << ".\n";
                     for ( const auto &[ succ, prob ] : env.get_transition( state, act ) ) {
-                        std::cout << "Successor: " << succ << " with p. " << prob << ".\n";
+                        std::cout << "Successor: ";
+                        print_trace( std::cout, succ );
+                        std::cout << " with p. " << prob << ".\n";
                     }
 
                 }
@@ -66,17 +116,81 @@ public:
                                                                    , reachable_states() 
                                                                    , config( config )   {  }
 
+    void set_config( const ExplorationSettings< value_t > &_config ){
+        config = _config;
+    }
+
+    /* replaces the bounds by copies of those of another solver with the
+     * same states, e.g. solved with other parameters of the environment,
+     * used by the next solve() if config.warm_start is set */
+    void import_bounds( const EnvironmentHandle &other ) {
+        env.copy_records_from( other );
+    }
+
+    const EnvironmentHandle &get_environment() const {
+        return env;
+    }
+
+    /* scheduler achieving points of the lower bound of the starting state,
+     * extracted from the bounds left by the last call of solve(), see
+     * solvers/scheduler.hpp */
+    Scheduler< state_t, action_t, value_t > extract_scheduler() {
+        return Scheduler< state_t, action_t, value_t >( env, starting_state );
+    }
+
+    // samples recorded during the last call of solve()
+    const MetricsRecorder< value_t > &get_metrics() const {
+        return metrics;
+    }
+
     VerificationResult< value_t > solve() {
+        return run( "" );
+    }
+
+    /* continues the run saved to filename by the checkpoints of solve(),
+     * with the same environment and config ( up to the limits of the run ),
+     * the sweeps are counted from the checkpoint, the time from the call */
+    VerificationResult< value_t > resume( const std::string &filename ) {
+        return run( filename );
+    }
+
+private:
+
+    // solve() from scratch ( or warm started ) if checkpoint is empty
+    VerificationResult< value_t > run( const std::string &checkpoint ) {
 
         auto start_time = std::chrono::steady_clock::now();
+        reset_profile();
+        memory.start();
 
         size_t sweeps = 0;
         reachable_states.clear();
-        state_t starting_state = std::get< 0 > ( env.reset( 0 ) );
+        starting_state = std::get< 0 > ( env.reset( derive_seed( config.seed, SeedStream::Environment, 0 ), !config.warm_start ) );
 
         env.set_config( config );
+        env.precompute_initial_bounds();
+
+        // reuse the bounds of the previous call
+        if ( !checkpoint.empty() )    { sweeps = load_checkpoint( checkpoint ); }
+        else if ( config.warm_start ) { env.revalidate_bounds(); }
         set_reachable_states();
-        
+        memory.end_initialization();
+        checkpoints.start( config.checkpoint_file, config.checkpoint_interval );
+
+        // lower end of the bounds, reference point of the hypervolumes
+        Point< value_t > ref_point = env.get_initial_bound().first;
+
+        auto record_metrics = [ & ](){
+            std::chrono::duration< double > elapsed = std::chrono::steady_clock::now() - start_time;
+            auto &bound = env.get_state_bound( starting_state );
+            metrics.record( { sweeps, elapsed.count(), bound.hausdorff_distance(),
+                              bound.lower().hypervolume( ref_point ),
+                              env.get_update_num(), env.num_states_explored() } );
+        };
+
+        metrics.reset( ( config.metrics_interval > 0 ) ? config.metrics_capacity : 0 );
+        if ( metrics.enabled() ) { record_metrics(); }
+
         while ( env.get_state_bound( starting_state ).hausdorff_distance() >= config.precision ){
 
             if ( config.trace ) {
@@ -89,8 +203,8 @@ public:
                 // initialize bound
                 if ( sweeps == 0 ) { env.discover( s ); }
 
-                // update all s,a pairs
-                for ( const action_t &act : env.get_actions( s ) ) {
+                // update all s,a pairs that were not eliminated
+                for ( const action_t &act : env.get_active_actions( s ) ) {
                     env.update_bound( s, act );
                 }
 
@@ -98,6 +212,10 @@ public:
             }
 
             sweeps++;
+
+            if ( metrics.enabled() && ( sweeps % config.metrics_interval == 0 ) ) { record_metrics(); }
+            if ( checkpoints.due() ) { write_checkpoint( sweeps ); }
+
             if ( ( config.max_episodes > 0 ) && ( sweeps >= config.max_episodes ) )  { break; }
 
             auto finish_time = std::chrono::steady_clock::now();
@@ -106,6 +224,20 @@ public:
             if ( exec_time.count() > config.max_seconds ) { break; }
         }
 
+        if ( metrics.enabled() ) {
+            // final state of the run, unless recorded in the last sweep
+            if ( sweeps % config.metrics_interval != 0 ) { record_metrics(); }
+            metrics.write_csv( config.metrics_filename, config.filename, "chvi", heuristic_name( config.action_heuristic ) );
+        }
+
+        // lets a warm started solve on the same model keep the bounds as they are
+        env.seal_records();
+
+        if ( checkpoints.enabled() ) {
+            write_checkpoint( sweeps );
+            checkpoints.finish();
+        }
+
         auto finish_time = std::chrono::steady_clock::now();
         auto start_bound = env.get_state_bound( starting_state );
         std::chrono::duration< double > exec_time = finish_time - start_time;
@@ -114,7 +246,10 @@ public:
                                        , start_bound.hausdorff_distance() < config.precision // bool converged
                                        , start_bound 
                                        , exec_time.count()
-                                       , env.num_states_explored() }; // num of explored states
+                                       , env.num_states_explored() // num of explored states
+                                       , env.num_states_frozen() // num of frozen states
+                                       , collect_profile() // time spent in each phase
+                                       , memory.finish( env.bound_memory_bytes() ) };
                                         
         return res;
     }
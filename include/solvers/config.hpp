@@ -3,13 +3,29 @@
 # include "utils/eigen_types.hpp"
 # include "utils/eigen_types.hpp"
 # include "solvers/bounds.hpp"
+# include "utils/memory.hpp"
+# include "utils/profiling.hpp"
 # include <vector>
 # include <chrono>
+# include <string>
 
 enum class ActionSelectionHeuristic { Hypervolume, 
                                       Pareto, 
                                       Hausdorff };
 
+inline std::string heuristic_name( ActionSelectionHeuristic heuristic ) {
+    switch ( heuristic ) {
+        case ActionSelectionHeuristic::Hypervolume:
+            return "hypervolume";
+        case ActionSelectionHeuristic::Pareto:
+            return "pareto";
+        case ActionSelectionHeuristic::Hausdorff:
+            return "hausdorff";
+        default:
+            return "unknown";
+    }
+}
+
 enum class OptimizationDirection { MAXIMIZE, 
                                    MINIMIZE };
 
@@ -61,6 +77,49 @@ struct ExplorationSettings{
     // filename to output logs in
     std::string filename;
 
+    // if enabled, the environment wrapper records the reverse edges of all
+    // discovered states, see EnvironmentWrapper::get_predecessors()
+    bool track_predecessors;
+
+    // if enabled, actions whose upper bound is dominated by the lower bound
+    // of the remaining actions are excluded from all future updates
+    bool action_elimination;
+
+    /* states whose bound distance drops below freeze_ratio * precision and
+     * whose successors are all frozen are no longer updated, BRTDP also stops
+     * its trajectories upon reaching them, 0 disables freezing */
+    double freeze_ratio;
+
+    /* if enabled, the initial bounds of states of sparse MDPs are computed
+     * by value iteration of each objective on its own before solving,
+     * instead of sharing the global bounds above */
+    bool vi_initialization;
+
+    /* if enabled, solve() keeps the bounds of the previous call ( or those
+     * imported by import_bounds() ) instead of starting from scratch, they
+     * are revalidated under the current config and environment first, see
+     * EnvironmentWrapper::revalidate_bounds() */
+    bool warm_start;
+
+    /* master seed of all random choices of the solver and the environment,
+     * identical config and seed give identical runs, 0 seeds randomly */
+    unsigned seed;
+
+    /* every metrics_interval episodes ( sweeps of CHVI ) the progress on the
+     * starting state is recorded into a ring buffer of the last
+     * metrics_capacity samples, which is appended to metrics_filename at the
+     * end of solve(), 0 disables the recording */
+    size_t metrics_interval;
+    size_t metrics_capacity;
+    std::string metrics_filename;
+
+    /* every checkpoint_interval seconds the solver writes all of its bounds
+     * and counters to checkpoint_file in the background, and once more at
+     * the end of solve(), the run can be continued by resume(), see
+     * solvers/checkpoint.hpp, 0 disables the checkpoints */
+    double checkpoint_interval;
+    std::string checkpoint_file;
+
     // basic config for testing 2 objective benchmarks
     ExplorationSettings() : precision( 0.1 )
                           , discount_param( 0.9 )
@@ -73,7 +132,18 @@ struct ExplorationSettings{
                           , trace( true )
                           , lower_bound_init()
                           , upper_bound_init() 
-                          , filename( "benchmark_test" ){ }
+                          , filename( "benchmark_test" )
+                          , track_predecessors( false )
+                          , action_elimination( true )
+                          , freeze_ratio( 0.1 )
+                          , vi_initialization( false )
+                          , warm_start( false )
+                          , seed( 0 )
+                          , metrics_interval( 0 )
+                          , metrics_capacity( 4096 )
+                          , metrics_filename( "../out/metrics.csv" )
+                          , checkpoint_interval( 0 )
+                          , checkpoint_file( "../out/checkpoint.bin" ){ }
 };
 
 
@@ -94,4 +164,13 @@ struct VerificationResult {
 
     // states that were explored / encountered during verification
     size_t states_explored;
+
+    // explored states whose bounds converged and were frozen
+    size_t states_frozen;
+
+    // time spent in each phase, only filled in when built with MO_PROFILING
+    ProfileBreakdown profile;
+
+    // bound footprint, peak resident set size and heap allocations of the run
+    MemoryUsage memory;
 };
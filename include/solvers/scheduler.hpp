@@ -0,0 +1,366 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <map>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+#include "geometry/polygon.hpp"
+#include "utils/eigen_types.hpp"
+#include "utils/prng.hpp"
+
+/*
+ * randomized memoryful scheduler achieving a point of the lower bound of the
+ * initial state, extracted from the bounds of a solver ( see
+ * BRTDPSolver::extract_scheduler() )
+ *
+ * the extraction performs one backup of every discovered state from the
+ * current lower bounds L( s ) with provenance recorded by the minkowski sum
+ * and the hull union:
+ *
+ *  every vertex v of the new curve L'( s ) stems from one action a and is the
+ *  sum r( s, a ) + discount * sum_i p_i w_i of one vertex w_i of L( s_i ) per
+ *  successor s_i, stored as the index of a and the indices of the w_i
+ *
+ * lower bounds only grow during the updates, so each vertex w of L( s ) is
+ * ( up to the pruning of the hull ) dominated by a mixture of two adjacent
+ * vertices of L'( s ), which is stored per vertex of L( s ) as well
+ *
+ * the memory of the scheduler is the vertex of the current state it aims for,
+ * in state s with target vertex w of L( s ) one of the two vertices of the
+ * mixture is sampled, its action is played, and the vertex of the observed
+ * successor becomes the next target, in expectation this achieves at least
+ * the target at the initial state ( for discount < 1 )
+ *
+ * actions whose successors were not all discovered keep the lower bound
+ * stored by the solver, which is the initial bound ( achieved by any
+ * scheduler ), after playing them and in undiscovered states the first
+ * enabled action is played, states without enabled actions have an empty
+ * curve and a free target
+ *
+ * all points are in the space of the solver, i.e. objectives that are
+ * minimized are multiplied by -1, see EnvironmentWrapper
+ */
+
+template < typename state_t, typename action_t, typename value_t >
+class Scheduler {
+
+public:
+
+    // vertex first with probability prob, otherwise vertex second
+    struct Mixture {
+        uint32_t first;
+        uint32_t second;
+        double prob;
+    };
+
+    // no target, any action achieves the bound
+    static constexpr uint32_t no_target = std::numeric_limits< uint32_t >::max();
+
+private:
+
+    struct Choice {
+
+        // index into StateRecord::actions
+        uint32_t action;
+
+        // first index of the successor vertices in StateRecord::targets
+        uint32_t offset;
+    };
+
+    struct StateRecord {
+
+        // vertices of L'( s ), sorted by decreasing x like all curves
+        std::vector< Point< value_t > > vertices;
+        std::vector< Choice > choices;
+
+        // actions of s and their successors ( in the order of the transition,
+        // empty if some successor was not discovered )
+        std::vector< action_t > actions;
+        std::vector< std::vector< state_t > > successors;
+
+        // vertex indices into L( s_i ), one per successor of the action
+        std::vector< uint32_t > targets;
+
+        // mixture of L'( s ) dominating each vertex of L( s )
+        std::vector< Mixture > mixtures;
+    };
+
+    struct LaneMemory {
+        Mixture target;
+        uint32_t vertex;
+    };
+
+    std::map< state_t, StateRecord > records;
+    state_t initial_state;
+    Mixture initial_target;
+
+    // memory of each lane, see the policy interface in models/batch_simulator.hpp
+    std::vector< LaneMemory > lanes;
+
+    static bool same_state( const state_t &lhs, const state_t &rhs ) {
+        return !( lhs < rhs ) && !( rhs < lhs );
+    }
+
+    static Mixture free_mixture() {
+        return { no_target, no_target, 1 };
+    }
+
+    /* mixture of two adjacent vertices of the curve with the same x
+     * coordinate as point ( clamped to the curve ), which dominates point
+     * whenever the downward closure of the curve contains it, free if the
+     * curve is empty ( no enabled actions ) */
+    static Mixture dominating_mixture( const std::vector< Point< value_t > > &curve,
+                                       const Point< value_t > &point ) {
+
+        if ( curve.empty() ) { return free_mixture(); }
+
+        uint32_t last = curve.size() - 1;
+
+        if ( ( curve.size() == 1 ) || ( point.size() == 1 ) ) { return { 0, 0, 1 }; }
+        if ( point[0] >= curve[0][0] ) { return { 0, 0, 1 }; }
+        if ( point[0] <= curve.back()[0] ) { return { last, last, 1 }; }
+
+        // first vertex with x <= point[0], the curve is sorted descending
+        auto it = std::lower_bound( curve.begin(), curve.end(), point,
+                                    []( const auto &v, const auto &pt ){ return v[0] > pt[0]; } );
+
+        uint32_t left = it - curve.begin();
+        const Point< value_t > &right_pt = curve[ left - 1 ], &left_pt = curve[ left ];
+
+        double prob = ( point[0] - left_pt[0] ) / ( right_pt[0] - left_pt[0] );
+        return { left - 1, left, prob };
+    }
+
+    template < typename wrapper_t >
+    StateRecord backup( wrapper_t &env, const state_t &s ) {
+
+        StateRecord rec;
+        value_t discount = env.get_config().discount_param;
+
+        std::vector< Polygon< value_t > > curves;
+        std::vector< std::vector< uint32_t > > origins;
+
+        for ( const action_t &a : env.get_active_actions( s ) ) {
+
+            auto transition = env.get_transition( s, a );
+
+            std::vector< Polygon< value_t > * > succ_curves;
+            std::vector< double > probs;
+            std::vector< state_t > succs;
+
+            for ( const auto &[ succ, prob ] : transition ) {
+                if ( !env.is_discovered( succ ) ) { break; }
+
+                succ_curves.push_back( &( env.get_state_bound( succ ).lower() ) );
+                probs.push_back( prob );
+                succs.push_back( succ );
+            }
+
+            std::vector< uint32_t > action_origins;
+
+            if ( succs.size() == transition.size() ) {
+                Polygon< value_t > curve = weighted_minkowski_sum( succ_curves, probs, &action_origins );
+                curve.multiply_scalar( discount );
+                curve.shift_vector( env.get_expected_reward( s, a ) );
+                curves.push_back( std::move( curve ) );
+            }
+            else {
+                curves.push_back( env.get_state_action_bound( s, a ).lower() );
+                succs.clear();
+            }
+
+            rec.actions.push_back( a );
+            rec.successors.push_back( std::move( succs ) );
+            origins.push_back( std::move( action_origins ) );
+        }
+
+        std::vector< Polygon< value_t > * > curve_ptrs;
+        for ( auto &curve : curves ) {
+            curve_ptrs.push_back( &curve );
+        }
+
+        // no pruning, the curve has to dominate the current lower bound
+        std::vector< std::pair< uint32_t, uint32_t > > hull_origins;
+        rec.vertices = hull_union( curve_ptrs, 0, &hull_origins ).get_vertices();
+
+        for ( const auto &[ action, vertex ] : hull_origins ) {
+            size_t width = rec.successors[ action ].size();
+            rec.choices.push_back( { action, static_cast< uint32_t >( rec.targets.size() ) } );
+
+            auto first = origins[ action ].begin() + vertex * width;
+            rec.targets.insert( rec.targets.end(), first, first + width );
+        }
+
+        return rec;
+    }
+
+public:
+
+    Scheduler() : records(), initial_state(), initial_target( free_mixture() ), lanes() {  }
+
+    /* extracts the scheduler from the bounds of all discovered states of env
+     * ( an EnvironmentWrapper ), initial is the state the runs start in,
+     * the target defaults to the vertex with the largest first objective */
+    template < typename wrapper_t >
+    Scheduler( wrapper_t &env, const state_t &initial ) : records()
+                                                        , initial_state( initial )
+                                                        , initial_target( free_mixture() )
+                                                        , lanes() {
+
+        for ( const state_t &s : env.discovered_states() ) {
+            records.emplace_hint( records.end(), s, backup( env, s ) );
+        }
+
+        for ( auto &[ s, rec ] : records ) {
+            for ( const auto &point : env.get_state_bound( s ).lower().get_vertices() ) {
+                rec.mixtures.push_back( dominating_mixture( rec.vertices, point ) );
+            }
+        }
+
+        auto initial_rec = records.find( initial_state );
+        if ( ( initial_rec != records.end() ) && !initial_rec->second.vertices.empty() ) {
+            initial_target = { 0, 0, 1 };
+        }
+    }
+
+    const state_t &get_initial_state() const {
+        return initial_state;
+    }
+
+    // achievable points of the initial state, sorted by decreasing x
+    const std::vector< Point< value_t > > &get_curve() const {
+        return records.at( initial_state ).vertices;
+    }
+
+    /* aims for target, which should lie in the downward closure of
+     * get_curve(), otherwise the closest point of the curve in the first
+     * objective is used */
+    void set_target( const Point< value_t > &target ) {
+        initial_target = dominating_mixture( get_curve(), target );
+    }
+
+    // aims for the vertex of the curve maximizing the weighted sum of objectives
+    void set_weights( const std::vector< value_t > &weights ) {
+        const auto &curve = get_curve();
+
+        if ( curve.empty() ) {
+            initial_target = free_mixture();
+            return;
+        }
+
+        uint32_t best = 0;
+        for ( uint32_t i = 1; i < curve.size(); i++ ) {
+            if ( dot_product( weights, curve[i] ) > dot_product( weights, curve[ best ] ) ) { best = i; }
+        }
+
+        initial_target = { best, best, 1 };
+    }
+
+    // expected value achieved for the current target, empty if there is none
+    Point< value_t > target_value() const {
+        const auto &curve = get_curve();
+
+        if ( initial_target.first == no_target ) { return {}; }
+
+        Point< value_t > res( curve[ initial_target.first ] );
+        multiply( static_cast< value_t >( initial_target.prob ), res );
+
+        Point< value_t > second( curve[ initial_target.second ] );
+        multiply( static_cast< value_t >( 1 - initial_target.prob ), second );
+        add( res, second );
+
+        return res;
+    }
+
+    size_t num_states() const {
+        return records.size();
+    }
+
+    // heap memory held by the records, in bytes ( map nodes are not included )
+    size_t memory_bytes() const {
+        size_t bytes = 0;
+
+        for ( const auto &[ _, rec ] : records ) {
+            bytes += rec.vertices.capacity() * sizeof( Point< value_t > )
+                   + rec.choices.capacity() * sizeof( Choice )
+                   + rec.actions.capacity() * sizeof( action_t )
+                   + rec.successors.capacity() * sizeof( std::vector< state_t > )
+                   + rec.targets.capacity() * sizeof( uint32_t )
+                   + rec.mixtures.capacity() * sizeof( Mixture );
+
+            for ( const auto &v : rec.vertices ) {
+                bytes += v.capacity() * sizeof( value_t );
+            }
+
+            for ( const auto &succs : rec.successors ) {
+                bytes += succs.capacity() * sizeof( state_t );
+            }
+        }
+
+        return bytes;
+    }
+
+    /*
+     * policy interface of BatchSimulator, a single run on Environment::step
+     * uses lane 0:
+     *
+     *  state = env.reset( seed ), reset( 0, state )
+     *  repeat: action = act( 0, env, state, gen ), next = env.step( action ),
+     *          observe( 0, state, action, reward, next ), state = next
+     */
+
+    void reset( size_t lane, const state_t &initial ) {
+        if ( lane >= lanes.size() ) { lanes.resize( lane + 1 ); }
+
+        lanes[ lane ].target = same_state( initial, initial_state ) ? initial_target : free_mixture();
+        lanes[ lane ].vertex = no_target;
+    }
+
+    template < typename env_t >
+    action_t act( size_t lane, const env_t &env, const state_t &state, PRNG &gen ) {
+        LaneMemory &mem = lanes[ lane ];
+        auto it = records.find( state );
+
+        if ( ( mem.target.first == no_target ) || ( it == records.end() ) || it->second.vertices.empty() ) {
+            mem.vertex = no_target;
+
+            auto actions = env.get_actions( state );
+            if ( actions.empty() ) {
+                throw std::runtime_error( "scheduler: no enabled action to play" );
+            }
+            return actions[0];
+        }
+
+        const Mixture &target = mem.target;
+        mem.vertex = ( gen.rand_float() < target.prob ) ? target.first : target.second;
+
+        const StateRecord &rec = it->second;
+        return rec.actions[ rec.choices[ mem.vertex ].action ];
+    }
+
+    template < typename reward_t >
+    void observe( size_t lane, const state_t &state, const action_t &, const reward_t &, const state_t &next ) {
+        LaneMemory &mem = lanes[ lane ];
+        uint32_t vertex = mem.vertex;
+        mem.target = free_mixture();
+
+        if ( vertex == no_target ) { return; }
+
+        const StateRecord &rec = records.at( state );
+        const Choice &choice = rec.choices[ vertex ];
+        const std::vector< state_t > &succs = rec.successors[ choice.action ];
+
+        // the successors are sorted, as keys of the transition
+        auto it = std::lower_bound( succs.begin(), succs.end(), next );
+        if ( ( it == succs.end() ) || !same_state( *it, next ) ) { return; }
+
+        auto succ_rec = records.find( next );
+        if ( succ_rec == records.end() ) { return; }
+
+        uint32_t target = rec.targets[ choice.offset + ( it - succs.begin() ) ];
+        mem.target = succ_rec->second.mixtures[ target ];
+    }
+};
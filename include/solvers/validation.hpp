@@ -0,0 +1,270 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <future>
+#include <random>
+#include <vector>
+#include "geometry/polygon.hpp"
+#include "models/environment.hpp"
+#include "solvers/config.hpp"
+#include "solvers/scheduler.hpp"
+#include "utils/prng.hpp"
+#include "utils/thread_pool.hpp"
+
+/*
+ * monte carlo validation of the lower bound reported by a solver
+ *
+ * for several vertices of the lower curve of the starting state, the
+ * scheduler extracted from the solver ( see solvers/scheduler.hpp ) aims for
+ * the vertex and is simulated by Environment::reset / step for many
+ * episodes, the mean discounted return of each objective is compared to the
+ * vertex, it should be at least as large up to the confidence interval and
+ * the discounted rewards cut off by the horizon
+ *
+ * the episodes are split into blocks simulated in parallel, each with its own
+ * copy of the environment, episode i is seeded from the Environment and
+ * Solver streams of the seed ( index i + 1 ), so that results with a nonzero
+ * seed do not depend on the number of threads
+ *
+ * an episode ends at the horizon or once step() reports a terminal state,
+ * the rewards of terminal states are assumed to be zero
+ */
+
+struct ValidationSettings {
+
+    // number of validated vertices of the curve, spread evenly over it
+    size_t vertices = 5;
+
+    // episodes simulated per vertex
+    size_t episodes = 2000;
+
+    /* maximum length of the episodes, 0 -> smallest horizon with
+     * discount^horizon < tail, at most max_horizon steps */
+    size_t horizon = 0;
+    double tail = 1e-4;
+    size_t max_horizon = 10000;
+
+    // quantile of the two sided confidence intervals ( 1.96 ~ 95% )
+    double z = 1.96;
+
+    // 0 threads -> one per hardware thread
+    size_t threads = 0;
+
+    // 0 -> random seed
+    unsigned seed = 0;
+};
+
+
+// validation of one vertex, all points in the direction of the objectives
+struct ValidationPoint {
+
+    // index of the vertex in the lower curve and the vertex itself
+    size_t vertex;
+    std::vector< double > reported;
+
+    // mean return of the episodes and half widths of the confidence intervals
+    std::vector< double > mean;
+    std::vector< double > half_width;
+
+    // bound on the discounted rewards after the horizon ( of any objective )
+    double truncation;
+
+    // episodes stopped by the horizon instead of a terminal state
+    size_t truncated;
+
+    // whether the reported vertex lies within the confidence intervals or below
+    bool achieved;
+};
+
+
+template < typename env_t >
+class SchedulerValidator {
+
+    using state_t = environment_state_t< env_t >;
+    using action_t = environment_action_t< env_t >;
+    using scheduler_t = Scheduler< state_t, action_t, double >;
+
+    ValidationSettings settings;
+    ThreadPool pool;
+
+    // one copy of the environment per block
+    std::vector< env_t > envs;
+
+    // +1 / -1 for maximized / minimized objectives, returns are multiplied
+    // by them to match the curves of the solver
+    std::vector< double > signs;
+    double discount;
+    size_t horizon;
+    double truncation;
+    unsigned master_seed;
+
+    // sums of returns and squared returns of a block of episodes
+    struct BlockStats {
+        std::vector< double > sum, sum_squares;
+        size_t truncated = 0;
+    };
+
+    BlockStats simulate_block( scheduler_t &scheduler, env_t &env, size_t lane, size_t first, size_t last ) const {
+
+        BlockStats stats{ std::vector< double >( signs.size(), 0 ), std::vector< double >( signs.size(), 0 ), 0 };
+        std::vector< double > ret( signs.size() );
+
+        for ( size_t episode = first; episode < last; episode++ ) {
+
+            auto [ state, _, terminated ] = env.reset( derive_seed( master_seed, SeedStream::Environment, episode + 1 ) );
+            unsigned solver_seed = derive_seed( master_seed, SeedStream::Solver, episode + 1 );
+            PRNG gen = ( solver_seed == 0 ) ? PRNG() : PRNG( solver_seed );
+
+            scheduler.reset( lane, state );
+            std::fill( ret.begin(), ret.end(), 0 );
+            double discount_pow = 1;
+
+            size_t t = 0;
+            for ( ; ( t < horizon ) && !terminated; t++ ) {
+                action_t action = scheduler.act( lane, env, state, gen );
+                auto [ next, reward, next_terminated ] = env.step( action );
+
+                for ( size_t i = 0; i < ret.size(); i++ ) {
+                    ret[i] += discount_pow * signs[i] * reward[i];
+                }
+
+                scheduler.observe( lane, state, action, reward, next );
+                state = next;
+                terminated = next_terminated;
+                discount_pow *= discount;
+            }
+
+            if ( !terminated ) { stats.truncated++; }
+
+            for ( size_t i = 0; i < ret.size(); i++ ) {
+                stats.sum[i] += ret[i];
+                stats.sum_squares[i] += ret[i] * ret[i];
+            }
+        }
+
+        return stats;
+    }
+
+public:
+
+    SchedulerValidator( const env_t &env,
+                        const ExplorationSettings< double > &config,
+                        const ValidationSettings &settings ) : settings( settings )
+                                                             , pool( settings.threads )
+                                                             , envs()
+                                                             , signs()
+                                                             , discount( config.discount_param )
+                                                             , horizon( settings.horizon )
+                                                             , truncation( 0 )
+                                                             , master_seed( settings.seed ) {
+
+        size_t blocks = std::max< size_t >( 1, std::min( pool.size(), settings.episodes ) );
+        envs.reserve( blocks );
+        for ( size_t i = 0; i < blocks; i++ ) {
+            envs.push_back( env );
+        }
+
+        auto [ min_reward, max_reward ] = env.reward_range();
+        for ( size_t i = 0; i < min_reward.size(); i++ ) {
+            bool minimize = ( i < config.directions.size() ) && ( config.directions[i] == OptimizationDirection::MINIMIZE );
+            signs.push_back( minimize ? -1 : 1 );
+        }
+
+        if ( horizon == 0 ) {
+            horizon = settings.max_horizon;
+            if ( discount < 1 ) {
+                double steps = std::ceil( std::log( settings.tail ) / std::log( discount ) );
+                horizon = std::min( horizon, static_cast< size_t >( steps ) );
+            }
+        }
+
+        // the rewards after the horizon are only bounded for discount < 1
+        if ( discount < 1 ) {
+            double max_abs = 0;
+            for ( size_t i = 0; i < min_reward.size(); i++ ) {
+                max_abs = std::max( { max_abs, std::abs( min_reward[i] ), std::abs( max_reward[i] ) } );
+            }
+            truncation = std::pow( discount, horizon ) * max_abs / ( 1 - discount );
+        }
+
+        if ( master_seed == 0 ) { master_seed = std::random_device()(); }
+    }
+
+    size_t get_horizon() const {
+        return horizon;
+    }
+
+    size_t num_threads() const {
+        return pool.size();
+    }
+
+    // simulates the scheduler aiming for target ( a point in the space of the solver )
+    ValidationPoint validate_point( scheduler_t &scheduler, const Point< double > &target ) {
+
+        size_t episodes = settings.episodes, blocks = envs.size();
+        size_t block_size = ( episodes + blocks - 1 ) / blocks;
+
+        scheduler.set_target( target );
+
+        // the lanes of the scheduler are allocated before the parallel part
+        for ( size_t block = 0; block < blocks; block++ ) {
+            scheduler.reset( block, scheduler.get_initial_state() );
+        }
+
+        std::vector< std::future< BlockStats > > futures;
+        for ( size_t block = 0; block < blocks; block++ ) {
+            size_t first = std::min( episodes, block * block_size );
+            size_t last = std::min( episodes, first + block_size );
+
+            futures.emplace_back( pool.submit( [ this, &scheduler, block, first, last ]{
+                return simulate_block( scheduler, envs[ block ], block, first, last );
+            }));
+        }
+
+        size_t objectives = signs.size();
+        std::vector< double > sum( objectives, 0 ), sum_squares( objectives, 0 );
+        ValidationPoint res{ 0, {}, {}, {}, truncation, 0, true };
+
+        for ( auto &future : futures ) {
+            BlockStats stats = future.get();
+            for ( size_t i = 0; i < objectives; i++ ) {
+                sum[i] += stats.sum[i];
+                sum_squares[i] += stats.sum_squares[i];
+            }
+            res.truncated += stats.truncated;
+        }
+
+        double n = static_cast< double >( episodes );
+        for ( size_t i = 0; i < objectives; i++ ) {
+            double mean = sum[i] / n;
+            double variance = ( episodes > 1 ) ? std::max( 0.0, ( sum_squares[i] - n * mean * mean ) / ( n - 1 ) ) : 0;
+            double half_width = settings.z * std::sqrt( variance / n );
+
+            res.achieved &= ( mean + half_width + truncation >= target[i] );
+
+            res.reported.push_back( signs[i] * target[i] );
+            res.mean.push_back( signs[i] * mean );
+            res.half_width.push_back( half_width );
+        }
+
+        return res;
+    }
+
+    // validates settings.vertices vertices of the reported lower curve
+    std::vector< ValidationPoint > validate( scheduler_t &scheduler, const Polygon< double > &lower ) {
+
+        const auto &vertices = lower.get_vertices();
+        size_t count = std::min( settings.vertices, vertices.size() );
+
+        std::vector< ValidationPoint > res;
+        for ( size_t k = 0; k < count; k++ ) {
+            size_t idx = ( count == 1 ) ? 0 : ( k * ( vertices.size() - 1 ) + ( count - 1 ) / 2 ) / ( count - 1 );
+
+            res.push_back( validate_point( scheduler, vertices[ idx ] ) );
+            res.back().vertex = idx;
+        }
+
+        return res;
+    }
+};
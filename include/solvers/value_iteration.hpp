@@ -0,0 +1,196 @@
+# pragma once
+
+# include <algorithm>
+# include <cmath>
+# include <limits>
+# include <vector>
+# include <Eigen/Core>
+# include <Eigen/SparseCore>
+# include "models/mdp.hpp"
+# include "solvers/config.hpp"
+# include "utils/eigen_types.hpp"
+
+/*
+ * scalar value iteration on sparse MDPs, each Bellman backup of all states is
+ * a single sparse matrix-vector product over the flattened model
+ */
+
+template < typename value_t >
+using Vector = Eigen::Matrix< value_t, Eigen::Dynamic, 1 >;
+
+
+/* the MDP flattened into one sparse matrix with a row for every enabled
+ * ( state, action ) pair ( choice ), choices of state s are stored in rows
+ * [ choice_offsets[s], choice_offsets[s + 1] )
+ *
+ * rewards are already multiplied by -1 for objectives that are minimized, so
+ * that all objectives can be maximized, same as in the environment wrapper
+ */
+template < typename value_t >
+struct ChoiceMatrix {
+
+    // choices x states
+    Matrix2D< value_t > transitions;
+
+    // reward vector ( over choices ) for each objective
+    std::vector< Vector< value_t > > rewards;
+
+    std::vector< size_t > choice_offsets;
+    std::vector< size_t > choice_actions;
+
+    size_t num_states() const {
+        return choice_offsets.size() - 1;
+    }
+
+    size_t num_choices() const {
+        return choice_actions.size();
+    }
+
+    size_t num_objectives() const {
+        return rewards.size();
+    }
+
+    ChoiceMatrix( const MDP< value_t > &mdp, const std::vector< OptimizationDirection > &directions ) {
+
+        Matrix3D< double > state_transitions = mdp.get_transition_matrix();
+        Matrix3D< value_t > reward_models = mdp.get_reward_matrix();
+
+        size_t num_states = state_transitions.size();
+        for ( const auto &state_matrix : state_transitions ) {
+            num_states = std::max( num_states, static_cast< size_t >( state_matrix.cols() ) );
+        }
+
+        std::vector< Eigen::Triplet< value_t > > triplets;
+        std::vector< std::vector< value_t > > choice_rewards( reward_models.size() );
+        choice_offsets.push_back( 0 );
+
+        for ( size_t s = 0; s < num_states; s++ ) {
+
+            if ( s < state_transitions.size() ) {
+                const auto &state_matrix = state_transitions[s];
+
+                for ( Eigen::Index a = 0; a < state_matrix.outerSize(); a++ ) {
+                    Matrix2D< double >::InnerIterator it( state_matrix, a );
+
+                    // action not enabled in s
+                    if ( !it ) { continue; }
+
+                    size_t row = choice_actions.size();
+                    for ( ; it; ++it ) {
+                        triplets.emplace_back( row, it.col(), static_cast< value_t >( it.value() ) );
+                    }
+
+                    for ( size_t i = 0; i < reward_models.size(); i++ ) {
+                        const auto &model = reward_models[i];
+                        value_t rew = ( a < model.rows() && s < static_cast< size_t >( model.cols() ) ) ? model.coeff( a, s ) : 0;
+
+                        if ( ( i < directions.size() ) && ( directions[i] == OptimizationDirection::MINIMIZE ) ) {
+                            rew *= -1;
+                        }
+
+                        choice_rewards[i].push_back( rew );
+                    }
+
+                    choice_actions.push_back( a );
+                }
+            }
+
+            choice_offsets.push_back( choice_actions.size() );
+        }
+
+        transitions = Matrix2D< value_t >( choice_actions.size(), num_states );
+        transitions.setFromTriplets( triplets.begin(), triplets.end() );
+        transitions.makeCompressed();
+
+        for ( const auto &rew : choice_rewards ) {
+            rewards.emplace_back( Eigen::Map< const Vector< value_t > >( rew.data(), rew.size() ) );
+        }
+    }
+
+    /* one Bellman backup of all states, res(s) = max ( or min ) over choices c
+     * of s of rew(c) + discount * sum P(c, s') values(s'), states without any
+     * choices keep their value */
+    void backup( const Vector< value_t > &rew, const Vector< value_t > &values,
+                 value_t discount, bool maximize, Vector< value_t > &res ) const {
+
+        Vector< value_t > choice_values = rew + discount * ( transitions * values );
+
+        for ( size_t s = 0; s < num_states(); s++ ) {
+
+            if ( choice_offsets[s] == choice_offsets[s + 1] ) {
+                res[s] = values[s];
+                continue;
+            }
+
+            auto segment = choice_values.segment( choice_offsets[s], choice_offsets[s + 1] - choice_offsets[s] );
+            res[s] = maximize ? segment.maxCoeff() : segment.minCoeff();
+        }
+    }
+
+    /* value iteration of a single objective, starting from init, stops once
+     * the largest change is below tolerance or after max_iterations sweeps.
+     *
+     * the Bellman operator is monotone, so starting from a vector above
+     * ( resp. below ) the optimal values, every iterate is again a valid
+     * upper ( resp. lower ) bound, regardless of when the iteration stops */
+    Vector< value_t > value_iteration( const Vector< value_t > &rew, Vector< value_t > init,
+                                       value_t discount, bool maximize, value_t tolerance,
+                                       size_t max_iterations, size_t *iterations = nullptr ) const {
+        Vector< value_t > next( init.size() );
+
+        size_t i = 0;
+        for ( ; i < max_iterations; i++ ) {
+            backup( rew, init, discount, maximize, next );
+            value_t change = ( next - init ).cwiseAbs().maxCoeff();
+            init.swap( next );
+
+            if ( change < tolerance ) { i++; break; }
+        }
+
+        if ( iterations ) { *iterations += i; }
+
+        return init;
+    }
+};
+
+
+/* per-state initial bounds from single objective value iteration, the upper
+ * bound of each state is its ideal point ( maximum of every objective on its
+ * own ), the lower bound is the point of minimal values of each objective,
+ * which is dominated by the value of every scheduler
+ *
+ * the iteration starts from the global initial bounds low, upp, so the
+ * resulting bounds are never worse than these
+ */
+template < typename value_t >
+std::vector< std::pair< Point< value_t >, Point< value_t > > >
+single_objective_bounds( const MDP< value_t > &mdp,
+                         const ExplorationSettings< value_t > &config,
+                         const Point< value_t > &low,
+                         const Point< value_t > &upp ) {
+
+    ChoiceMatrix< value_t > model( mdp, config.directions );
+
+    size_t states = model.num_states();
+    size_t objectives = model.num_objectives();
+
+    std::vector< std::pair< Point< value_t >, Point< value_t > > > result( states, { Point< value_t >( objectives ),
+                                                                                   Point< value_t >( objectives ) } );
+
+    value_t tolerance = config.precision / 100;
+    size_t max_iterations = 10000;
+
+    for ( size_t i = 0; i < objectives; i++ ) {
+        Vector< value_t > lower = model.value_iteration( model.rewards[i], Vector< value_t >::Constant( states, low[i] ),
+                                                         config.discount_param, false, tolerance, max_iterations );
+        Vector< value_t > upper = model.value_iteration( model.rewards[i], Vector< value_t >::Constant( states, upp[i] ),
+                                                         config.discount_param, true, tolerance, max_iterations );
+
+        for ( size_t s = 0; s < states; s++ ) {
+            result[s].first[i] = lower[s];
+            result[s].second[i] = upper[s];
+        }
+    }
+
+    return result;
+}
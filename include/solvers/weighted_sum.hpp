@@ -0,0 +1,326 @@
+# pragma once
+
+# include <algorithm>
+# include <chrono>
+# include <cmath>
+# include <vector>
+# include "geometry/polygon.hpp"
+# include "models/env_wrapper.hpp"
+# include "models/mdp.hpp"
+# include "solvers/bounds.hpp"
+# include "solvers/config.hpp"
+# include "solvers/value_iteration.hpp"
+# include "utils/eigen_types.hpp"
+# include "utils/memory.hpp"
+
+/*
+ * outer approximation of the ( convex ) pareto curve of a sparse MDP using
+ * weighted sum scalarizations, for each weight vector w a single objective
+ * MDP with reward w . r is solved by value iteration ( see
+ * solvers/value_iteration.hpp ), which gives
+ *
+ *  1) a point achieved by the greedy scheduler -> vertex of the lower bound
+ *  2) an upper bound on w . x for all achievable x -> facet of the upper bound
+ *
+ * the weights are then chosen as normals of the edges of the lower curve
+ * with the largest distance to the upper curve, until the distance of the two
+ * bounds on the starting state is below precision
+ *
+ * only two objectives are currently supported ( same as in the polygons )
+ */
+template < typename value_t >
+class WeightedSumSolver {
+
+    // halfspace w . x <= offset
+    struct Facet {
+        Point< value_t > weights;
+        value_t offset;
+    };
+
+    ExplorationSettings< value_t > config;
+
+    MDP< value_t > *mdp;
+
+    // lower / upper end of the value of each objective ( after directions )
+    Point< value_t > min_values, max_values;
+
+    std::vector< Point< value_t > > achieved_points;
+    std::vector< Facet > facets;
+
+    // weight vectors of the edges of the lower curve that were already solved
+    std::vector< Point< value_t > > used_weights;
+
+    size_t backups = 0;
+
+    value_t tolerance() const {
+        if ( config.discount_param < 1 ) {
+            return config.precision * ( 1 - config.discount_param ) / 10;
+        }
+        return config.precision / 10;
+    }
+
+    /* solves the scalarized MDP for weights w, returns the value of the
+     * greedy scheduler in all objectives and an upper bound on w . x */
+    std::pair< Point< value_t >, value_t > solve_weighted( const ChoiceMatrix< value_t > &model,
+                                                           const Point< value_t > &w ) {
+        size_t states = model.num_states();
+        size_t start = mdp->get_initial_state();
+
+        Vector< value_t > rew = Vector< value_t >::Zero( model.num_choices() );
+        value_t upper_init = 0;
+        for ( size_t i = 0; i < w.size(); i++ ) {
+            rew += w[i] * model.rewards[i];
+            upper_init += w[i] * max_values[i];
+        }
+
+        // iterating from above keeps the values an upper bound
+        size_t iterations = 0;
+        Vector< value_t > values = model.value_iteration( rew, Vector< value_t >::Constant( states, upper_init ),
+                                                          config.discount_param, true, tolerance(),
+                                                          max_iterations, &iterations );
+
+        // greedy scheduler w.r.t. the upper values
+        Vector< value_t > choice_values = rew + config.discount_param * ( model.transitions * values );
+        std::vector< Eigen::Triplet< value_t > > triplets;
+        std::vector< size_t > policy( states, 0 );
+
+        for ( size_t s = 0; s < states; s++ ) {
+            size_t first = model.choice_offsets[s], last = model.choice_offsets[s + 1];
+            if ( first == last ) {
+                /* no enabled actions, the state keeps its initial bound like
+                 * in the value iteration above and in EnvironmentWrapper */
+                policy[s] = model.num_choices();
+                continue;
+            }
+
+            size_t best = first;
+            for ( size_t c = first + 1; c < last; c++ ) {
+                if ( choice_values[c] > choice_values[best] ) { best = c; }
+            }
+
+            policy[s] = best;
+            for ( typename Matrix2D< value_t >::InnerIterator it( model.transitions, best ); it; ++it ) {
+                triplets.emplace_back( s, it.col(), it.value() );
+            }
+        }
+
+        Matrix2D< value_t > policy_transitions( states, states );
+        policy_transitions.setFromTriplets( triplets.begin(), triplets.end() );
+
+        // evaluate the scheduler in each objective, from below
+        size_t evaluations = 0;
+        Point< value_t > point( w.size() );
+        for ( size_t i = 0; i < w.size(); i++ ) {
+            Vector< value_t > policy_rew( states );
+            for ( size_t s = 0; s < states; s++ ) {
+                policy_rew[s] = ( policy[s] == model.num_choices() ) ? min_values[i] : model.rewards[i][ policy[s] ];
+            }
+
+            Vector< value_t > res = Vector< value_t >::Constant( states, min_values[i] );
+            for ( size_t k = 0; k < max_iterations; k++ ) {
+                Vector< value_t > next = policy_rew + config.discount_param * ( policy_transitions * res );
+                value_t change = ( next - res ).cwiseAbs().maxCoeff();
+                res.swap( next );
+                evaluations++;
+
+                if ( change < tolerance() ) { break; }
+            }
+
+            point[i] = res[ start ];
+        }
+
+        /* counted in state-action backups like the updates of the other
+         * solvers, a sweep of the value iteration backs up every choice,
+         * a sweep of the evaluation only the choice of the scheduler */
+        backups += iterations * model.num_choices() + evaluations * states;
+        return { point, values[ start ] };
+    }
+
+    // upper-right boundary of the intersection of all facets, ordered with
+    // descending x like the other curves
+    Polygon< value_t > upper_curve() const {
+
+        // sort by the angle of the normal, from ( 1, 0 ) to ( 0, 1 )
+        std::vector< Facet > sorted( facets );
+        std::sort( sorted.begin(), sorted.end(), []( const Facet &a, const Facet &b ) {
+            return std::atan2( a.weights[1], a.weights[0] ) < std::atan2( b.weights[1], b.weights[0] );
+        });
+
+        auto intersect = []( const Facet &a, const Facet &b ) {
+            value_t det = a.weights[0] * b.weights[1] - a.weights[1] * b.weights[0];
+            return Point< value_t >{ ( a.offset * b.weights[1] - b.offset * a.weights[1] ) / det,
+                                     ( a.weights[0] * b.offset - b.weights[0] * a.offset ) / det };
+        };
+
+        auto violates = []( const Facet &f, const Point< value_t > &pt ) {
+            return f.weights[0] * pt[0] + f.weights[1] * pt[1] > f.offset;
+        };
+
+        // remove facets that are parallel ( keep the tighter one )
+        std::vector< Facet > lines;
+        for ( const auto &f : sorted ) {
+            if ( !lines.empty() && approx_zero( lines.back().weights[0] * f.weights[1] - lines.back().weights[1] * f.weights[0] ) ) {
+                if ( f.offset < lines.back().offset ) { lines.back() = f; }
+                continue;
+            }
+
+            // pop facets that are not part of the boundary anymore
+            while ( lines.size() >= 2 && violates( f, intersect( lines[ lines.size() - 2 ], lines.back() ) ) ) {
+                lines.pop_back();
+            }
+            lines.push_back( f );
+        }
+
+        std::vector< Point< value_t > > vertices;
+        for ( size_t i = 0; i + 1 < lines.size(); i++ ) {
+            Point< value_t > vertex = intersect( lines[i], lines[i + 1] );
+
+            // almost parallel facets may produce the same vertex twice
+            if ( !vertices.empty() && approx_equal( vertices.back()[0], vertex[0] ) && approx_equal( vertices.back()[1], vertex[1] ) ) {
+                continue;
+            }
+            vertices.push_back( vertex );
+        }
+
+        return Polygon< value_t >( std::move( vertices ) );
+    }
+
+    Polygon< value_t > lower_curve() {
+        std::vector< Point< value_t > > points( achieved_points );
+        return Polygon< value_t >( upper_right_hull( points, 0 ) );
+    }
+
+    /* picks the normal of the edge of the lower curve that is furthest from
+     * the upper curve, returns false if all edges were already solved */
+    bool next_weights( const Polygon< value_t > &lower, const Polygon< value_t > &upper, Point< value_t > &res ) const {
+
+        value_t max_gap = -1;
+        const auto &vertices = lower.get_vertices();
+
+        for ( size_t i = 0; i + 1 < vertices.size(); i++ ) {
+            value_t wx = vertices[i + 1][1] - vertices[i][1], wy = vertices[i][0] - vertices[i + 1][0];
+            value_t norm = wx + wy;
+            Point< value_t > w = { wx / norm, wy / norm };
+
+            bool used = std::any_of( used_weights.begin(), used_weights.end(), [ & ]( const auto &u ){
+                return approx_equal( u[0], w[0] ) && approx_equal( u[1], w[1] );
+            });
+            if ( used ) { continue; }
+
+            // largest violation of the edge's supporting line by the upper curve
+            value_t offset = dot_product( w, vertices[i] ), gap = 0;
+            for ( const auto &v : upper.get_vertices() ) {
+                gap = std::max( gap, dot_product( w, v ) - offset );
+            }
+
+            if ( gap > max_gap ) {
+                max_gap = gap;
+                res = w;
+            }
+        }
+
+        return max_gap >= 0;
+    }
+
+    void add_weights( const ChoiceMatrix< value_t > &model, const Point< value_t > &w ) {
+        auto [ point, upper ] = solve_weighted( model, w );
+        achieved_points.push_back( point );
+        facets.push_back( { w, upper } );
+        used_weights.push_back( w );
+    }
+
+public:
+
+    // cap on sweeps of each value iteration
+    size_t max_iterations = 100000;
+
+    WeightedSumSolver( MDP< value_t > &mdp,
+                       const ExplorationSettings< value_t > &config ) : config( config )
+                                                                      , mdp( &mdp ) {  }
+
+    void set_config( const ExplorationSettings< value_t > &_config ){
+        config = _config;
+    }
+
+    VerificationResult< value_t > solve() {
+
+        auto start_time = std::chrono::steady_clock::now();
+
+        MemoryTracker memory;
+        memory.start();
+
+        achieved_points.clear();
+        facets.clear();
+        used_weights.clear();
+        backups = 0;
+
+        // global bounds, with the same conventions as the other solvers
+        EnvironmentWrapper< size_t, size_t, std::vector< value_t >, value_t, MDP< value_t > > env( mdp );
+        env.set_config( config );
+        std::tie( min_values, max_values ) = env.get_initial_bound();
+        auto [ ref_point, _ ] = env.min_max_discounted_reward();
+
+        ChoiceMatrix< value_t > model( *mdp, config.directions );
+
+        if ( model.num_objectives() > 2 ) {
+            throw std::runtime_error( "weighted sum solver supports at most two objectives" );
+        }
+        memory.end_initialization();
+
+        // extreme points of the curve, single objective optima
+        for ( size_t i = 0; i < model.num_objectives(); i++ ) {
+            Point< value_t > w( model.num_objectives(), 0 );
+            w[i] = 1;
+            add_weights( model, w );
+        }
+
+        // the single objective case is solved by the one scalarization
+        Bounds< value_t > result = ( model.num_objectives() == 1 ) ? Bounds< value_t >( lower_curve(), Polygon< value_t >( std::vector< Point< value_t > >{ { facets[0].offset } } ) )
+                                                                   : Bounds< value_t >( lower_curve(), upper_curve() );
+
+        size_t solves = model.num_objectives();
+        Point< value_t > w;
+
+        while ( true ) {
+            result.init_facets();
+            result.downward_closure( ref_point );
+
+            if ( config.trace ) {
+                std::cout << "Weighted sum solve #" << solves;
+                if ( !w.empty() ) { std::cout << ", weights " << w[0] << " " << w[1]; }
+                std::cout << ".\ndistance: " << result.hausdorff_distance() << ".\n";
+            }
+
+            if ( result.hausdorff_distance() < config.precision ) { break; }
+
+            if ( !next_weights( result.lower(), result.upper(), w ) ) { break; }
+
+            add_weights( model, w );
+            result = Bounds< value_t >( lower_curve(), upper_curve() );
+            solves++;
+
+            if ( ( config.max_episodes > 0 ) && ( solves >= config.max_episodes ) )  { break; }
+
+            auto finish_time = std::chrono::steady_clock::now();
+            std::chrono::duration< double > exec_time = finish_time - start_time;
+
+            if ( exec_time.count() > config.max_seconds ) { break; }
+        }
+
+        result.init_facets();
+        result.downward_closure( ref_point );
+
+        auto finish_time = std::chrono::steady_clock::now();
+        std::chrono::duration< double > exec_time = finish_time - start_time;
+
+        VerificationResult< value_t > res{ backups // num of state-action backups
+                                       , result.hausdorff_distance() < config.precision // bool converged
+                                       , result
+                                       , exec_time.count()
+                                       , model.num_states() // all states are explored
+                                       , 0 // no freezing
+                                       , ProfileBreakdown() // not profiled
+                                       , memory.finish( result.memory_bytes() ) };
+        return res;
+    }
+};
@@ -0,0 +1,64 @@
+# pragma once
+
+# include <cstddef>
+
+/*
+ * global heap allocation counter, compiled in by defining MO_COUNT_ALLOCATIONS
+ * ( cmake -DMO_COUNT_ALLOCATIONS=ON ), which links src/allocation_counter.cpp
+ * replacing the global operator new / delete of the executables
+ *
+ * the global statistics cover all threads, the thread statistics only the
+ * allocations and deallocations made by the calling thread, e.g. one solver
+ * run among several concurrent ones
+ *
+ * without it all the statistics stay zero
+ */
+
+struct AllocationStats {
+    size_t allocations = 0;
+    size_t deallocations = 0;
+
+    // total bytes ever allocated
+    size_t allocated_bytes = 0;
+
+    // bytes currently allocated and their maximum
+    size_t live_bytes = 0;
+    size_t peak_live_bytes = 0;
+};
+
+
+# ifdef MO_COUNT_ALLOCATIONS
+
+constexpr bool allocation_counting_enabled = true;
+
+// snapshot of the counters, defined in src/allocation_counter.cpp
+AllocationStats allocation_stats();
+
+// resets the peak of live bytes to the current value
+void reset_peak_allocation();
+
+// statistics of the calling thread, the live bytes count from the last reset
+AllocationStats thread_allocation_stats();
+
+/* resets the live bytes of the calling thread and their peak to zero, so that
+ * they measure the growth of the heap from now on ( blocks allocated before
+ * and freed afterwards do not make them negative ) */
+void reset_thread_live_bytes();
+
+# else
+
+constexpr bool allocation_counting_enabled = false;
+
+inline AllocationStats allocation_stats() {
+    return AllocationStats();
+}
+
+inline void reset_peak_allocation() {  }
+
+inline AllocationStats thread_allocation_stats() {
+    return AllocationStats();
+}
+
+inline void reset_thread_live_bytes() {  }
+
+# endif
@@ -0,0 +1,142 @@
+# pragma once
+
+# include <atomic>
+# include <cstddef>
+# include <fstream>
+# include <sstream>
+# include <string>
+# include "utils/allocation_counter.hpp"
+
+/*
+ * process memory statistics read from /proc/self ( linux only, all queries
+ * return 0 elsewhere )
+ */
+
+// value of a "Key:   1234 kB" line of /proc/self/status, in kB
+inline size_t read_proc_status( const std::string &key ) {
+
+    std::ifstream status( "/proc/self/status" );
+    std::string line;
+
+    while ( std::getline( status, line ) ) {
+        if ( line.compare( 0, key.size() + 1, key + ":" ) == 0 ) {
+            std::istringstream value( line.substr( key.size() + 1 ) );
+            size_t kb = 0;
+            value >> kb;
+            return kb;
+        }
+    }
+
+    return 0;
+}
+
+// current resident set size in kB
+inline size_t current_rss_kb() {
+    return read_proc_status( "VmRSS" );
+}
+
+// peak resident set size in kB, since the start or the last reset_peak_rss()
+inline size_t peak_rss_kb() {
+    return read_proc_status( "VmHWM" );
+}
+
+// number of calls of reset_peak_rss(), a peak read later covers the time since the last one
+inline std::atomic< size_t > peak_rss_resets{ 0 };
+
+/* resets the peak resident set size to the current one, so that the peak of
+ * a single phase can be measured, returns false if not supported */
+inline bool reset_peak_rss() {
+    peak_rss_resets.fetch_add( 1 );
+
+    std::ofstream clear_refs( "/proc/self/clear_refs" );
+    if ( !clear_refs ) { return false; }
+
+    clear_refs << "5";
+    return static_cast< bool >( clear_refs.flush() );
+}
+
+
+// memory figures of one solver run, reported in VerificationResult
+struct MemoryUsage {
+
+    // heap memory held by all stored bounds at the end, in bytes
+    size_t bound_bytes = 0;
+
+    /* peak resident set size after the initialization / at the end, in kB,
+     * process-wide, so only valid if no other tracked run overlapped this
+     * one, both are 0 otherwise */
+    bool rss_valid = false;
+    size_t init_peak_rss = 0;
+    size_t solve_peak_rss = 0;
+
+    /* heap allocations of the solver thread during the run and the largest
+     * growth of its live heap, only counted with MO_COUNT_ALLOCATIONS */
+    size_t allocations = 0;
+    size_t allocated_bytes = 0;
+    size_t peak_live_bytes = 0;
+};
+
+
+// number of MemoryTrackers running and started so far in the process
+inline std::atomic< size_t > running_memory_trackers{ 0 };
+inline std::atomic< size_t > started_memory_trackers{ 0 };
+
+
+/* samples the memory figures at the end of each phase of a solver run, the
+ * run has to stay on the thread that called start()
+ *
+ * the allocations are counted per thread, the resident set size is process
+ * wide, it is only reset and reported if no other tracker runs at the same
+ * time ( e.g. solvers on a BenchmarkHarness with more than one thread ) and
+ * nothing else resets it meanwhile ( e.g. the parser ) */
+class MemoryTracker {
+
+    AllocationStats start_stats;
+    MemoryUsage usage;
+
+    /* whether no other tracker was running at start(), the trackers started
+     * and the peak resets until then, see exclusive() */
+    bool alone = false;
+    size_t started = 0;
+    size_t resets = 0;
+
+    // no other tracker started and nobody reset the peak since start()
+    bool exclusive() const {
+        return alone && ( started_memory_trackers.load() == started ) && ( peak_rss_resets.load() == resets );
+    }
+
+public:
+
+    void start() {
+        usage = MemoryUsage();
+
+        alone = ( running_memory_trackers.fetch_add( 1 ) == 0 );
+        started = started_memory_trackers.fetch_add( 1 ) + 1;
+
+        if ( alone ) { alone = reset_peak_rss(); }
+        resets = peak_rss_resets.load();
+
+        reset_thread_live_bytes();
+        start_stats = thread_allocation_stats();
+    }
+
+    void end_initialization() {
+        if ( exclusive() ) { usage.init_peak_rss = peak_rss_kb(); }
+    }
+
+    MemoryUsage finish( size_t bound_bytes ) {
+        AllocationStats stats = thread_allocation_stats();
+
+        usage.bound_bytes = bound_bytes;
+        usage.rss_valid = exclusive();
+        usage.solve_peak_rss = usage.rss_valid ? peak_rss_kb() : 0;
+        if ( !usage.rss_valid ) { usage.init_peak_rss = 0; }
+
+        usage.allocations = stats.allocations - start_stats.allocations;
+        usage.allocated_bytes = stats.allocated_bytes - start_stats.allocated_bytes;
+        usage.peak_live_bytes = stats.peak_live_bytes;
+
+        running_memory_trackers.fetch_sub( 1 );
+        return usage;
+    }
+};
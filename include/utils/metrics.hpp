@@ -0,0 +1,119 @@
+# pragma once
+
+# include <fstream>
+# include <mutex>
+# include <sstream>
+# include <string>
+# include <vector>
+
+/*
+ * lightweight convergence telemetry of the solvers, samples of the progress on
+ * the starting state are kept in a preallocated ring buffer ( only the newest
+ * capacity samples are kept ) and written out once the solver finishes
+ */
+
+template < typename value_t >
+struct MetricsSample {
+
+    // episode of BRTDP / sweep of CHVI
+    size_t episode;
+
+    // wall-clock time since the start of solve()
+    double seconds;
+
+    // hausdorff distance of the bounds on the starting state
+    value_t distance;
+
+    // hypervolume of the lower bound on the starting state
+    value_t hypervolume;
+
+    size_t updates;
+    size_t explored;
+};
+
+
+template < typename value_t >
+class MetricsRecorder {
+
+    std::vector< MetricsSample< value_t > > buffer;
+
+    // position of the next sample, total number of samples recorded
+    size_t next = 0;
+    size_t recorded = 0;
+
+public:
+
+    explicit MetricsRecorder( size_t capacity = 0 ) : buffer( capacity ) {  }
+
+    // drops all samples, reallocating only if the capacity changed
+    void reset( size_t capacity ) {
+        if ( capacity != buffer.size() ) {
+            buffer = std::vector< MetricsSample< value_t > >( capacity );
+        }
+        next = 0;
+        recorded = 0;
+    }
+
+    bool enabled() const {
+        return !buffer.empty();
+    }
+
+    void record( const MetricsSample< value_t > &sample ) {
+        if ( buffer.empty() ) { return; }
+
+        buffer[ next ] = sample;
+        next = ( next + 1 ) % buffer.size();
+        recorded++;
+    }
+
+    // samples that were overwritten since the buffer was full
+    size_t dropped() const {
+        return ( recorded > buffer.size() ) ? recorded - buffer.size() : 0;
+    }
+
+    // kept samples, from the oldest one
+    std::vector< MetricsSample< value_t > > samples() const {
+        std::vector< MetricsSample< value_t > > res;
+
+        size_t kept = recorded - dropped();
+        size_t first = ( recorded > buffer.size() ) ? next : 0;
+
+        for ( size_t i = 0; i < kept; i++ ) {
+            res.push_back( buffer[ ( first + i ) % buffer.size() ] );
+        }
+
+        return res;
+    }
+
+    /* appends the samples to a csv file, a header is written if the file is
+     * empty, rows are labeled by the benchmark name, solver and heuristic
+     *
+     * writes from multiple threads ( e.g. the parallel benchmark harness ) are
+     * serialized, so that rows of different runs do not interleave */
+    void write_csv( const std::string &filename, const std::string &name,
+                    const std::string &solver, const std::string &heuristic ) const {
+
+        static std::mutex file_mutex;
+
+        std::stringstream rows;
+        for ( const auto &sample : samples() ) {
+            rows << name << ";" << solver << ";" << heuristic << ";" << sample.episode << ";";
+            rows << sample.seconds << ";" << sample.distance << ";" << sample.hypervolume << ";";
+            rows << sample.updates << ";" << sample.explored << "\n";
+        }
+
+        std::lock_guard< std::mutex > lock( file_mutex );
+
+        bool empty;
+        {
+            std::ifstream in( filename );
+            empty = !in.good() || ( in.peek() == std::ifstream::traits_type::eof() );
+        }
+
+        std::ofstream out( filename, std::fstream::app );
+        if ( empty ) {
+            out << "Benchmark name;solver;heuristic;episode;time;distance;hypervolume;updates;explored\n";
+        }
+        out << rows.str();
+    }
+};
@@ -1,9 +1,13 @@
 #pragma once
 
+#include <array>
 #include <cassert>
 #include <cmath>
+#include <cstdint>
 #include <limits>
+#include <iterator>
 #include <random>
+#include <type_traits>
 
 /* helper class for PRNG, and helper functions for 
  * floating point comparisons, etc. 
@@ -19,35 +23,146 @@ bool approx_zero( prob_t x, prob_t eps=1e-7 ){
     return approx_equal( x, 0.0 );
 }
 
+// one step of the splitmix64 generator, used to expand seeds
+inline uint64_t splitmix64( uint64_t &x ) {
+    uint64_t z = ( x += 0x9e3779b97f4a7c15ULL );
+    z = ( z ^ ( z >> 30 ) ) * 0xbf58476d1ce4e5b9ULL;
+    z = ( z ^ ( z >> 27 ) ) * 0x94d049bb133111ebULL;
+    return z ^ ( z >> 31 );
+}
+
+/* independent streams of seeds derived from a single master seed, so that
+ * e.g. the solver and the environment never share a random sequence */
+enum class SeedStream : uint64_t { Run = 1,
+                                   Solver,
+                                   Environment };
+
+/* derives the index-th seed of stream from master by splitmix64, the result
+ * is never zero, so that it is not mistaken for a random initialization.
+ *
+ * master seed 0 stands for random seeding and is propagated as 0 */
+inline unsigned derive_seed( unsigned master, SeedStream stream, uint64_t index ) {
+
+    if ( master == 0 ) { return 0; }
+
+    uint64_t z = master;
+    for ( uint64_t word : { static_cast< uint64_t >( stream ), index } ) {
+        z += word;
+        z = splitmix64( z );
+    }
+
+    unsigned res = static_cast< unsigned >( z ^ ( z >> 32 ) );
+    return ( res == 0 ) ? 1 : res;
+}
+
+/* xoshiro256** generator ( Blackman, Vigna ), 32 bytes of state
+ *
+ * jump() advances the generator by 2^128 steps, split() uses it to hand out
+ * non-overlapping streams, e.g. one per thread, without any locking
+ *
+ * copies continue the same sequence, copies that should not ( e.g. of an
+ * environment, one per task ) are reseeded by reset() or split off
+ */
 class PRNG {
 
-    std::random_device rd;
-    std::mt19937 gen{ std::random_device{}() };
+public:
+    using State = std::array< uint64_t, 4 >;
 
-    std::uniform_int_distribution< int > int_dist;
-    std::uniform_real_distribution< double > float_dist; 
-    std::uniform_real_distribution< double > prob_dist{ 0.0, 1.0 };
+private:
+    State s;
+
+    static uint64_t rotl( uint64_t x, int k ) {
+        return ( x << k ) | ( x >> ( 64 - k ) );
+    }
 
 public:
-    PRNG() : rd(), gen() {
-        gen.seed( rd() );
+    PRNG() {
+        seed();
     }
 
+    explicit PRNG( unsigned seed ) {
+        this->seed( seed );
+    }
+
+    explicit PRNG( const State &state ) : s( state ) {  }
+
     void seed() {
-        gen.seed( rd() );
+        std::random_device rd;
+        uint64_t x = ( static_cast< uint64_t >( rd() ) << 32 ) | rd();
+        for ( auto &word : s ) { word = splitmix64( x ); }
     }
     void seed( unsigned seed ) {
-        gen.seed( seed );
+        uint64_t x = seed;
+        for ( auto &word : s ) { word = splitmix64( x ); }
     }
 
-    int rand_int( int min, int max ){
-        int_dist = std::uniform_int_distribution< int >( min, max );
-        return int_dist( gen );
+    // raw state, e.g. for checkpoints
+    const State &get_state() const {
+        return s;
+    }
+    void set_state( const State &state ) {
+        s = state;
     }
 
+    uint64_t next() {
+        uint64_t res = rotl( s[1] * 5, 7 ) * 9;
+        uint64_t t = s[1] << 17;
 
+        s[2] ^= s[0];
+        s[3] ^= s[1];
+        s[1] ^= s[2];
+        s[0] ^= s[3];
+        s[2] ^= t;
+        s[3] = rotl( s[3], 45 );
+
+        return res;
+    }
+
+    // equivalent to 2^128 calls of next()
+    void jump() {
+        static constexpr uint64_t JUMP[] = { 0x180ec6d33cfd0abaULL, 0xd5a61266f0c9392cULL,
+                                             0xa9582618e03fc9aaULL, 0x39abdc4529b1661cULL };
+        State res = { 0, 0, 0, 0 };
+
+        for ( uint64_t word : JUMP ) {
+            for ( int b = 0; b < 64; b++ ) {
+                if ( word & ( uint64_t( 1 ) << b ) ) {
+                    for ( size_t i = 0; i < 4; i++ ) { res[i] ^= s[i]; }
+                }
+                next();
+            }
+        }
+
+        s = res;
+    }
+
+    // returns a generator on the current stream, and moves this one past it
+    PRNG split() {
+        PRNG res( s );
+        jump();
+        return res;
+    }
+
+    // uniform integer from [ min, max ] by Lemire's multiply-shift method, unbiased
+    int rand_int( int min, int max ){
+        uint64_t range = static_cast< uint64_t >( static_cast< int64_t >( max ) - min ) + 1;
+        uint64_t m = ( next() >> 32 ) * range;
+        uint32_t low = static_cast< uint32_t >( m );
+
+        if ( low < range ) {
+            uint32_t threshold = static_cast< uint32_t >( ( uint64_t( 1 ) << 32 ) % range );
+            while ( low < threshold ) {
+                m = ( next() >> 32 ) * range;
+                low = static_cast< uint32_t >( m );
+            }
+        }
+
+        return static_cast< int >( min + static_cast< int64_t >( m >> 32 ) );
+    }
+
+    // uniform double from [ 0, 1 ), 53 random bits
     double rand_float() {
-        return float_dist( gen );
+        return static_cast< double >( next() >> 11 ) * 0x1.0p-53;
     }
 
     double rand_float( double min, double max ) {
@@ -56,7 +171,7 @@ public:
 
     template < typename prob_t > 
     prob_t rand_probability() {
-        return static_cast< prob_t >( prob_dist( gen ) );
+        return static_cast< prob_t >( rand_float() );
     }
 
     // sample from distribution container (no validation) //
@@ -82,7 +197,15 @@ public:
                template < typename > class container_t >
     value_t sample_uniformly( const container_t< value_t > &cont ){ 
         int idx = rand_int( 0, cont.size() - 1 );
-        return *std::next( cont.begin(), idx );
+
+        using iterator_t = typename container_t< value_t >::const_iterator;
+        if constexpr ( std::is_same_v< typename std::iterator_traits< iterator_t >::iterator_category,
+                                       std::random_access_iterator_tag > ) {
+            return cont.begin()[ idx ];
+        }
+        else {
+            return *std::next( cont.begin(), idx );
+        }
     }
 };
 
@@ -0,0 +1,121 @@
+# pragma once
+
+# include <array>
+# include <chrono>
+# include <cstddef>
+
+/*
+ * per-phase profiling of the solvers, enabled at compile time by defining
+ * MO_PROFILING ( cmake -DMO_PROFILING=ON ), otherwise all timers compile to
+ * nothing and the breakdowns stay zero
+ *
+ * the timers accumulate into a thread local breakdown, so that solvers running
+ * in parallel do not share it. phases may be nested ( e.g. hausdorff distances
+ * recomputed during successor selection ), so their times are not additive.
+ */
+
+enum class ProfilePhase : size_t { ActionSelection = 0,
+                                   SuccessorDiffs,
+                                   Discover,
+                                   ActionElimination,
+                                   MinkowskiSum,
+                                   HullUnion,
+                                   Hausdorff,
+                                   Count };
+
+constexpr size_t num_profile_phases = static_cast< size_t >( ProfilePhase::Count );
+
+inline const char *phase_name( ProfilePhase phase ) {
+    switch ( phase ) {
+        case ProfilePhase::ActionSelection:
+            return "action selection";
+        case ProfilePhase::SuccessorDiffs:
+            return "successor diffs";
+        case ProfilePhase::Discover:
+            return "discover";
+        case ProfilePhase::ActionElimination:
+            return "action elimination";
+        case ProfilePhase::MinkowskiSum:
+            return "minkowski sum";
+        case ProfilePhase::HullUnion:
+            return "hull union";
+        case ProfilePhase::Hausdorff:
+            return "hausdorff";
+        default:
+            return "unknown";
+    }
+}
+
+struct PhaseStats {
+    double seconds = 0;
+    size_t calls = 0;
+};
+
+struct ProfileBreakdown {
+
+    std::array< PhaseStats, num_profile_phases > phases{};
+
+    PhaseStats &operator[]( ProfilePhase phase ) {
+        return phases[ static_cast< size_t >( phase ) ];
+    }
+
+    const PhaseStats &operator[]( ProfilePhase phase ) const {
+        return phases[ static_cast< size_t >( phase ) ];
+    }
+};
+
+
+# ifdef MO_PROFILING
+
+constexpr bool profiling_enabled = true;
+
+inline ProfileBreakdown &thread_profile() {
+    thread_local ProfileBreakdown profile;
+    return profile;
+}
+
+// adds the lifetime of the object to the given phase
+class ScopedTimer {
+
+    PhaseStats &stats;
+    std::chrono::steady_clock::time_point start;
+
+public:
+    explicit ScopedTimer( ProfilePhase phase ) : stats( thread_profile()[ phase ] )
+                                               , start( std::chrono::steady_clock::now() ) {  }
+
+    ScopedTimer( const ScopedTimer & ) = delete;
+    ScopedTimer &operator=( const ScopedTimer & ) = delete;
+
+    ~ScopedTimer() {
+        std::chrono::duration< double > elapsed = std::chrono::steady_clock::now() - start;
+        stats.seconds += elapsed.count();
+        stats.calls++;
+    }
+};
+
+# define PROFILE_CONCAT_IMPL( a, b ) a##b
+# define PROFILE_CONCAT( a, b ) PROFILE_CONCAT_IMPL( a, b )
+# define PROFILE_SCOPE( phase ) ScopedTimer PROFILE_CONCAT( profile_timer_, __LINE__ )( phase )
+
+inline void reset_profile() {
+    thread_profile() = ProfileBreakdown();
+}
+
+inline ProfileBreakdown collect_profile() {
+    return thread_profile();
+}
+
+# else
+
+constexpr bool profiling_enabled = false;
+
+# define PROFILE_SCOPE( phase )
+
+inline void reset_profile() {  }
+
+inline ProfileBreakdown collect_profile() {
+    return ProfileBreakdown();
+}
+
+# endif
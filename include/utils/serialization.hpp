@@ -0,0 +1,427 @@
+# pragma once
+
+# include <array>
+# include <atomic>
+# include <cerrno>
+# include <cstdint>
+# include <cstdio>
+# include <cstring>
+# include <fstream>
+# include <functional>
+# include <future>
+# include <iterator>
+# include <memory>
+# include <stdexcept>
+# include <string>
+# include <tuple>
+# include <type_traits>
+# include <utility>
+# include <vector>
+# include <fcntl.h>
+# include <unistd.h>
+
+/*
+ * compact binary serialization, used by the solver checkpoints ( see
+ * solvers/checkpoint.hpp )
+ *
+ * values are written to an in-memory buffer by BinaryWriter ( or streamed in
+ * chunks, e.g. to a file ) and read back by BinaryReader, both dispatch to
+ * Serializer< T >, which copies trivially
+ * copyable types byte by byte, and handles pairs, tuples, arrays and vectors
+ * element-wise, other types ( e.g. states with a std::pair member ) can be
+ * supported by specializing Serializer
+ *
+ * the bytes are in the native layout, files are only meant to be read on the
+ * same platform by a build with the same types
+ */
+
+class BinaryWriter;
+class BinaryReader;
+
+template < typename T, typename = void >
+struct Serializer;
+
+// whether Serializer< T > is defined
+template < typename T, typename = void >
+struct is_serializable : std::false_type {  };
+
+template < typename T >
+struct is_serializable< T, std::void_t< decltype( sizeof( Serializer< T > ) ) > > : std::true_type {  };
+
+template < typename T >
+constexpr bool is_serializable_v = is_serializable< T >::value;
+
+
+class BinaryWriter {
+
+    using sink_t = std::function< void( std::vector< char > && ) >;
+
+    std::vector< char > buffer;
+
+    // receives the buffer once it holds chunk_size bytes, if set
+    sink_t sink;
+    size_t chunk_size = 0;
+
+public:
+
+    BinaryWriter() = default;
+
+    /* hands the written bytes to sink in chunks of ( at least ) chunk_size
+     * bytes, so that the whole output is never held in memory, the last
+     * chunk is handed over by flush() */
+    BinaryWriter( sink_t _sink, size_t _chunk_size ) : sink( std::move( _sink ) ),
+                                                       chunk_size( _chunk_size ) {
+        buffer.reserve( chunk_size );
+    }
+
+    void write_bytes( const void *data, size_t size ) {
+        const char *bytes = static_cast< const char * >( data );
+        buffer.insert( buffer.end(), bytes, bytes + size );
+
+        if ( sink && ( buffer.size() >= chunk_size ) ) { flush(); }
+    }
+
+    void flush() {
+        if ( !sink || buffer.empty() ) { return; }
+
+        sink( std::move( buffer ) );
+        buffer = std::vector< char >();
+        buffer.reserve( chunk_size );
+    }
+
+    template < typename T >
+    void write( const T &value ) {
+        Serializer< T >::write( *this, value );
+    }
+
+    // raw copy of n trivially copyable values
+    template < typename T >
+    void write_array( const T *values, size_t n ) {
+        static_assert( std::is_trivially_copyable_v< T > );
+        write_bytes( values, n * sizeof( T ) );
+    }
+
+    void reserve( size_t size ) {
+        buffer.reserve( size );
+    }
+
+    size_t size() const {
+        return buffer.size();
+    }
+
+    // the written bytes, the writer is left empty
+    std::vector< char > release() {
+        return std::move( buffer );
+    }
+};
+
+
+class BinaryReader {
+
+    std::vector< char > buffer;
+    size_t position = 0;
+
+public:
+
+    explicit BinaryReader( std::vector< char > &&data ) : buffer( std::move( data ) ) {  }
+
+    void read_bytes( void *data, size_t size ) {
+        if ( size > buffer.size() - position ) {
+            throw std::runtime_error( "unexpected end of binary data" );
+        }
+
+        std::memcpy( data, buffer.data() + position, size );
+        position += size;
+    }
+
+    template < typename T >
+    void read( T &value ) {
+        Serializer< T >::read( *this, value );
+    }
+
+    // for default constructible types
+    template < typename T >
+    T read() {
+        T value{};
+        read( value );
+        return value;
+    }
+
+    template < typename T >
+    void read_array( T *values, size_t n ) {
+        static_assert( std::is_trivially_copyable_v< T > );
+        if ( n > ( buffer.size() - position ) / sizeof( T ) ) {
+            throw std::runtime_error( "unexpected end of binary data" );
+        }
+        read_bytes( values, n * sizeof( T ) );
+    }
+
+    size_t remaining() const {
+        return buffer.size() - position;
+    }
+};
+
+
+template < typename T >
+struct Serializer< T, std::enable_if_t< std::is_trivially_copyable_v< T > > > {
+
+    static void write( BinaryWriter &out, const T &value ) {
+        out.write_bytes( &value, sizeof( T ) );
+    }
+
+    static void read( BinaryReader &in, T &value ) {
+        in.read_bytes( &value, sizeof( T ) );
+    }
+};
+
+
+template < typename T, typename U >
+struct Serializer< std::pair< T, U >, std::enable_if_t< !std::is_trivially_copyable_v< std::pair< T, U > > &&
+                                                        is_serializable_v< T > && is_serializable_v< U > > > {
+
+    static void write( BinaryWriter &out, const std::pair< T, U > &value ) {
+        out.write( value.first );
+        out.write( value.second );
+    }
+
+    static void read( BinaryReader &in, std::pair< T, U > &value ) {
+        in.read( value.first );
+        in.read( value.second );
+    }
+};
+
+
+template < typename... Ts >
+struct Serializer< std::tuple< Ts... >, std::enable_if_t< !std::is_trivially_copyable_v< std::tuple< Ts... > > &&
+                                                          ( is_serializable_v< Ts > && ... ) > > {
+
+    static void write( BinaryWriter &out, const std::tuple< Ts... > &value ) {
+        std::apply( [ &out ]( const auto &... elems ){ ( out.write( elems ), ... ); }, value );
+    }
+
+    static void read( BinaryReader &in, std::tuple< Ts... > &value ) {
+        std::apply( [ &in ]( auto &... elems ){ ( in.read( elems ), ... ); }, value );
+    }
+};
+
+
+template < typename T, size_t N >
+struct Serializer< std::array< T, N >, std::enable_if_t< !std::is_trivially_copyable_v< std::array< T, N > > &&
+                                                         is_serializable_v< T > > > {
+
+    static void write( BinaryWriter &out, const std::array< T, N > &value ) {
+        for ( const T &elem : value ) { out.write( elem ); }
+    }
+
+    static void read( BinaryReader &in, std::array< T, N > &value ) {
+        for ( T &elem : value ) { in.read( elem ); }
+    }
+};
+
+
+// length prefixed, trivially copyable elements are copied at once
+template < typename T >
+struct Serializer< std::vector< T >, std::enable_if_t< is_serializable_v< T > > > {
+
+    static void write( BinaryWriter &out, const std::vector< T > &value ) {
+        out.write( static_cast< uint64_t >( value.size() ) );
+
+        if constexpr ( std::is_trivially_copyable_v< T > ) { out.write_array( value.data(), value.size() ); }
+        else { for ( const T &elem : value ) { out.write( elem ); } }
+    }
+
+    static void read( BinaryReader &in, std::vector< T > &value ) {
+        uint64_t size = in.read< uint64_t >();
+
+        // checked before the allocation, the size may be corrupted
+        if ( size > in.remaining() ) {
+            throw std::runtime_error( "unexpected end of binary data" );
+        }
+
+        if constexpr ( std::is_trivially_copyable_v< T > ) {
+            value.resize( size );
+            in.read_array( value.data(), size );
+        }
+        else {
+            value.clear();
+            for ( uint64_t i = 0; i < size; i++ ) { value.push_back( in.read< T >() ); }
+        }
+    }
+};
+
+
+template <>
+struct Serializer< std::string > {
+
+    static void write( BinaryWriter &out, const std::string &value ) {
+        out.write( static_cast< uint64_t >( value.size() ) );
+        out.write_array( value.data(), value.size() );
+    }
+
+    static void read( BinaryReader &in, std::string &value ) {
+        std::vector< char > chars;
+        Serializer< std::vector< char > >::read( in, chars );
+        value.assign( chars.begin(), chars.end() );
+    }
+};
+
+
+/* a file that is written to a temporary file next to filename, unique to
+ * the process and the AtomicFile, and replaces filename only once complete
+ * and flushed to disk ( see commit() ), so that a crash at any point leaves
+ * either the previous or the new file in place
+ *
+ * the temporary file is removed if the AtomicFile is destroyed before the
+ * commit ( posix only ) */
+class AtomicFile {
+
+    std::string filename, tmp_filename;
+    int fd = -1;
+
+    // distinguishes the temporary files of one process
+    static inline std::atomic< uint64_t > counter{ 0 };
+
+    static std::string directory( const std::string &filename ) {
+        size_t slash = filename.rfind( '/' );
+        if ( slash == std::string::npos ) { return "."; }
+        return ( slash == 0 ) ? "/" : filename.substr( 0, slash );
+    }
+
+public:
+
+    explicit AtomicFile( const std::string &_filename ) : filename( _filename ) {
+        tmp_filename = filename + ".tmp." + std::to_string( ::getpid() ) + "." + std::to_string( counter++ );
+        fd = ::open( tmp_filename.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644 );
+    }
+
+    AtomicFile( const AtomicFile & ) = delete;
+    AtomicFile &operator=( const AtomicFile & ) = delete;
+
+    ~AtomicFile() {
+        if ( fd >= 0 ) {
+            ::close( fd );
+            ::unlink( tmp_filename.c_str() );
+        }
+    }
+
+    bool is_open() const {
+        return fd >= 0;
+    }
+
+    // appends size bytes, returns whether all of them were written
+    bool write( const char *data, size_t size ) {
+        while ( ( fd >= 0 ) && ( size > 0 ) ) {
+            ssize_t written = ::write( fd, data, size );
+            if ( written < 0 ) {
+                if ( errno == EINTR ) { continue; }
+                return false;
+            }
+
+            data += written;
+            size -= written;
+        }
+
+        return fd >= 0;
+    }
+
+    /* flushes the data to disk, renames the file to filename and flushes the
+     * directory entry, returns whether all of it succeeded */
+    bool commit() {
+        if ( fd < 0 ) { return false; }
+
+        bool res = ( ::fsync( fd ) == 0 );
+        res &= ( ::close( fd ) == 0 );
+        fd = -1;
+
+        if ( !res || ( std::rename( tmp_filename.c_str(), filename.c_str() ) != 0 ) ) {
+            ::unlink( tmp_filename.c_str() );
+            return false;
+        }
+
+        int dir = ::open( directory( filename ).c_str(), O_RDONLY );
+        if ( dir >= 0 ) {
+            ::fsync( dir );
+            ::close( dir );
+        }
+
+        return true;
+    }
+};
+
+
+// writes data to filename at once, see AtomicFile, returns whether the write succeeded
+inline bool write_file_atomic( const std::string &filename, const std::vector< char > &data ) {
+    AtomicFile file( filename );
+    return file.write( data.data(), data.size() ) && file.commit();
+}
+
+
+inline std::vector< char > read_file( const std::string &filename ) {
+
+    std::ifstream in( filename, std::ios::binary );
+    if ( !in.good() ) {
+        throw std::runtime_error( "file " + filename + " does not exist" );
+    }
+
+    return std::vector< char >( std::istreambuf_iterator< char >( in ), std::istreambuf_iterator< char >() );
+}
+
+
+/* writes an AtomicFile chunk by chunk on a background thread, at most one
+ * operation ( a chunk or the final commit ) is in flight, so that the caller
+ * holds at most one more chunk in memory while it produces the next one */
+class AsyncFileWriter {
+
+    std::unique_ptr< AtomicFile > file;
+    std::future< bool > pending;
+    bool good = true;
+
+    void wait_pending() {
+        if ( pending.valid() ) { good &= pending.get(); }
+    }
+
+public:
+
+    AsyncFileWriter() = default;
+    AsyncFileWriter( AsyncFileWriter && ) = default;
+    AsyncFileWriter &operator=( AsyncFileWriter && ) = default;
+
+    ~AsyncFileWriter() {
+        wait();
+    }
+
+    // starts a new file, returns whether the previous one was written
+    bool open( const std::string &filename ) {
+        bool res = wait();
+        file = std::make_unique< AtomicFile >( filename );
+        good = file->is_open();
+        return res;
+    }
+
+    void append( std::vector< char > &&chunk ) {
+        wait_pending();
+        if ( !good ) { return; }
+
+        pending = std::async( std::launch::async, [ f = file.get(), chunk = std::move( chunk ) ]{
+            return f->write( chunk.data(), chunk.size() );
+        });
+    }
+
+    // replaces the file once all chunks are written, see AtomicFile::commit()
+    void commit() {
+        wait_pending();
+        if ( !good ) { return; }
+
+        pending = std::async( std::launch::async, [ f = file.get() ]{ return f->commit(); } );
+    }
+
+    /* waits for the pending operations, returns whether the last file was
+     * written completely ( true if none ), an uncommitted file is discarded */
+    bool wait() {
+        wait_pending();
+        bool res = good && ( file == nullptr || !file->is_open() );
+        file.reset();
+        good = true;
+        return res;
+    }
+};
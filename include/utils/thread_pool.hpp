@@ -0,0 +1,93 @@
+# pragma once
+
+# include <condition_variable>
+# include <functional>
+# include <future>
+# include <memory>
+# include <mutex>
+# include <queue>
+# include <thread>
+# include <vector>
+
+/* fixed size pool of worker threads executing independent tasks in the order
+ * of submission, used to run benchmarks / simulations in parallel
+ */
+class ThreadPool {
+
+    std::vector< std::thread > workers;
+    std::queue< std::function< void() > > tasks;
+
+    std::mutex queue_mutex;
+    std::condition_variable condition;
+    bool stopping = false;
+
+    void work() {
+        while ( true ) {
+            std::function< void() > task;
+
+            {
+                std::unique_lock< std::mutex > lock( queue_mutex );
+                condition.wait( lock, [ this ]{ return stopping || !tasks.empty(); } );
+
+                // finish all remaining tasks before stopping
+                if ( tasks.empty() ) { return; }
+
+                task = std::move( tasks.front() );
+                tasks.pop();
+            }
+
+            task();
+        }
+    }
+
+public:
+
+    // 0 threads -> one per hardware thread
+    explicit ThreadPool( size_t threads = 0 ) {
+        if ( threads == 0 ) {
+            threads = std::max( 1u, std::thread::hardware_concurrency() );
+        }
+
+        for ( size_t i = 0; i < threads; i++ ) {
+            workers.emplace_back( [ this ]{ work(); } );
+        }
+    }
+
+    ThreadPool( const ThreadPool & ) = delete;
+    ThreadPool &operator=( const ThreadPool & ) = delete;
+
+    ~ThreadPool() {
+        {
+            std::lock_guard< std::mutex > lock( queue_mutex );
+            stopping = true;
+        }
+
+        condition.notify_all();
+        for ( auto &worker : workers ) {
+            worker.join();
+        }
+    }
+
+    size_t size() const {
+        return workers.size();
+    }
+
+    // schedules task, its result ( or exception ) is returned through the future
+    template < typename task_t >
+    auto submit( task_t &&task ) -> std::future< decltype( task() ) > {
+
+        using result_t = decltype( task() );
+
+        // packaged_task is move only, std::function requires copies
+        auto packaged = std::make_shared< std::packaged_task< result_t() > >( std::forward< task_t >( task ) );
+        std::future< result_t > result = packaged->get_future();
+
+        {
+            std::lock_guard< std::mutex > lock( queue_mutex );
+            tasks.emplace( [ packaged ]{ ( *packaged )(); } );
+        }
+
+        condition.notify_one();
+        return result;
+    }
+};
@@ -0,0 +1,129 @@
+# pragma once
+
+#include "benchmarks/frozen_lake.hpp"
+#include "benchmarks/racetrack.hpp"
+#include "benchmarks/sea_treasure.hpp"
+
+#include "models/env_wrapper.hpp"
+#include "models/mdp.hpp"
+
+#include "parser.hpp"
+
+#include "solvers/brtdp.hpp"
+#include "solvers/config.hpp"
+#include "solvers/validation.hpp"
+
+#include <fstream>
+#include <iostream>
+#include <string>
+
+/*
+ * monte carlo validation of the lower curves ( see solvers/validation.hpp ),
+ * each benchmark is solved once by BRTDP with the settings of
+ * eval_benchmarks, the extracted scheduler is simulated for several vertices
+ * of the curve, one row per vertex is written to filename:
+ *
+ *  benchmark;vertex;reported 1;reported 2;mean 1;mean 2;ci 1;ci 2;truncation;truncated;achieved
+ */
+
+template < typename env_t >
+void validate_benchmark( std::ofstream &out, const env_t &env,
+                         const ExplorationSettings< double > &config,
+                         const ValidationSettings &settings ) {
+
+    using state_t = environment_state_t< env_t >;
+    using action_t = environment_action_t< env_t >;
+    using wrapper_t = EnvironmentWrapper< state_t, action_t, std::vector< double >, double, env_t >;
+
+    env_t local( env );
+    BRTDPSolver< state_t, action_t, double, env_t > brtdp( wrapper_t( &local ), config );
+    auto res = brtdp.solve();
+
+    if ( !res.converged ) {
+        std::cout << config.filename << " : BRTDP did not converge, validating the current curve.\n";
+    }
+
+    auto scheduler = brtdp.extract_scheduler();
+    SchedulerValidator< env_t > validator( env, config, settings );
+
+    size_t failed = 0;
+    for ( const auto &point : validator.validate( scheduler, res.result_bound.lower() ) ) {
+        out << config.filename << ";" << point.vertex << ";";
+        out << point.reported[0] << ";" << point.reported[1] << ";";
+        out << point.mean[0] << ";" << point.mean[1] << ";";
+        out << point.half_width[0] << ";" << point.half_width[1] << ";";
+        out << point.truncation << ";" << point.truncated << ";" << point.achieved << std::endl;
+
+        if ( !point.achieved ) { failed++; }
+    }
+
+    std::cout << config.filename << " : " << failed << " vertices not achieved in simulation ( horizon "
+              << validator.get_horizon() << ", " << validator.num_threads() << " threads ).\n";
+}
+
+
+inline void eval_validation( const ValidationSettings &settings=ValidationSettings(),
+                             const std::string &filename="../out/validation.csv" ) {
+
+    std::ofstream out( filename );
+    out << "benchmark;vertex;reported 1;reported 2;mean 1;mean 2;ci 1;ci 2;truncation;truncated;achieved\n";
+
+    ExplorationSettings< double > config;
+    config.trace = false;
+    config.action_heuristic = ActionSelectionHeuristic::Pareto;
+    config.max_depth = 0;
+    config.max_episodes = 0;
+    config.max_seconds = 300;
+    config.precision = 0.01;
+    config.depth_constant = 50;
+    config.discount_param = 0.95;
+    config.seed = settings.seed;
+
+    // same settings as eval_uav
+    PrismParser parser;
+    config.directions = { OptimizationDirection::MINIMIZE, OptimizationDirection::MINIMIZE };
+    config.filename = "uav5";
+    validate_benchmark( out, parser.parse_model( "../benchmarks/uav/uav5.tra",
+                                                 { "../benchmarks/uav/uav51.trew", "../benchmarks/uav/uav52.trew" }, 0 ),
+                        config, settings );
+
+    config.directions = { OptimizationDirection::MAXIMIZE, OptimizationDirection::MAXIMIZE };
+    config.filename = "teamform3";
+    validate_benchmark( out, parser.parse_model( "../benchmarks/teamform/teamform3.tra",
+                                                 { "../benchmarks/teamform/teamform31.trew", "../benchmarks/teamform/teamform32.trew" }, 0 ),
+                        config, settings );
+
+    config.directions = { OptimizationDirection::MINIMIZE, OptimizationDirection::MINIMIZE };
+    config.filename = "pareto_taskgraph5";
+    validate_benchmark( out, parser.parse_model( "../benchmarks/taskgraph/taskgraph5.tra",
+                                                 { "../benchmarks/taskgraph/taskgraph52.trew", "../benchmarks/taskgraph/taskgraph51.trew" }, 0 ),
+                        config, settings );
+
+    // same settings as eval_treasure and eval_frozenlake
+    config.directions = { OptimizationDirection::MAXIMIZE, OptimizationDirection::MINIMIZE };
+
+    DeepSeaTreasure dst, dst_convex;
+    dst.from_file( "../benchmarks/treasures/treasure-concave.txt" );
+    dst_convex.from_file( "../benchmarks/treasures/treasure-convex.txt" );
+
+    config.filename = "treasure-concave";
+    validate_benchmark( out, dst, config, settings );
+    config.filename = "treasure-convex";
+    validate_benchmark( out, dst_convex, config, settings );
+
+    config.filename = "lake-easy";
+    validate_benchmark( out, FrozenLake(), config, settings );
+
+    // same settings as eval_racetrack, the episodes end at the goal
+    config.max_depth = 100;
+    config.max_seconds = 600;
+    config.directions = { OptimizationDirection::MINIMIZE, OptimizationDirection::MINIMIZE };
+    config.discount_param = 1;
+    config.lower_bound_init = { -1000, -1000 };
+    config.upper_bound_init = { 0, 0 };
+
+    Racetrack easy;
+    easy.from_file( "../benchmarks/racetracks/racetrack-easy.track", true );
+    config.filename = "racetrack-easy";
+    validate_benchmark( out, easy, config, settings );
+}
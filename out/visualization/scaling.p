@@ -0,0 +1,25 @@
+# plots out/scaling.csv ( see include/scaling_evaluation.hpp ), run from out/
+set datafile separator ";"
+set key font ", 16" top left
+set tics font ", 16"
+set pointsize 1
+set logscale xy
+set xlabel "states"
+
+set terminal pngcairo size 1600,700
+set output "visualization/scaling.png"
+set multiplot layout 1,2
+
+engine( name, col ) = ( strcol( 3 ) eq name ) ? column( col ) : NaN
+
+set ylabel "solve time [s]"
+plot 'scaling.csv' using 1:(engine( "brtdp", 5 )) every ::1 with linespoints pt 5 title "BRTDP", \
+     'scaling.csv' using 1:(engine( "chvi", 5 )) every ::1 with linespoints pt 7 title "CHVI", \
+     'scaling.csv' using 1:(engine( "weighted sum", 5 )) every ::1 with linespoints pt 9 title "weighted sum"
+
+set ylabel "peak rss [kB]"
+plot 'scaling.csv' using 1:(engine( "brtdp", 8 )) every ::1 with linespoints pt 5 title "BRTDP", \
+     'scaling.csv' using 1:(engine( "chvi", 8 )) every ::1 with linespoints pt 7 title "CHVI", \
+     'scaling.csv' using 1:(engine( "weighted sum", 8 )) every ::1 with linespoints pt 9 title "weighted sum"
+
+unset multiplot
@@ -0,0 +1,143 @@
+# include <algorithm>
+# include <atomic>
+# include <cstdlib>
+# include <new>
+# include "utils/allocation_counter.hpp"
+
+/*
+ * replacement of the global allocation functions counting all heap
+ * allocations, see include/utils/allocation_counter.hpp
+ *
+ * each block is prefixed by its size, so that the live bytes can be tracked
+ * by the unsized operator delete as well
+ */
+
+namespace {
+
+std::atomic< size_t > allocations{ 0 };
+std::atomic< size_t > deallocations{ 0 };
+std::atomic< size_t > allocated_bytes{ 0 };
+std::atomic< size_t > live_bytes{ 0 };
+std::atomic< size_t > peak_live_bytes{ 0 };
+
+// counters of the current thread, the live bytes go negative when blocks of other threads are freed
+thread_local size_t thread_allocations = 0;
+thread_local size_t thread_deallocations = 0;
+thread_local size_t thread_allocated_bytes = 0;
+thread_local long long thread_live_bytes = 0;
+thread_local long long thread_peak_live_bytes = 0;
+
+// keeps the user part of the block aligned for any fundamental type
+constexpr size_t header_size = alignof( std::max_align_t );
+
+void *counted_allocate( size_t size ) {
+    void *block = std::malloc( size + header_size );
+    if ( block == nullptr ) { return nullptr; }
+
+    *static_cast< size_t * >( block ) = size;
+
+    allocations.fetch_add( 1, std::memory_order_relaxed );
+    allocated_bytes.fetch_add( size, std::memory_order_relaxed );
+    size_t live = live_bytes.fetch_add( size, std::memory_order_relaxed ) + size;
+
+    size_t peak = peak_live_bytes.load( std::memory_order_relaxed );
+    while ( ( live > peak ) && !peak_live_bytes.compare_exchange_weak( peak, live, std::memory_order_relaxed ) ) {  }
+
+    thread_allocations++;
+    thread_allocated_bytes += size;
+    thread_live_bytes += size;
+    thread_peak_live_bytes = std::max( thread_peak_live_bytes, thread_live_bytes );
+
+    return static_cast< char * >( block ) + header_size;
+}
+
+void counted_free( void *ptr ) {
+    if ( ptr == nullptr ) { return; }
+
+    void *block = static_cast< char * >( ptr ) - header_size;
+
+    size_t size = *static_cast< size_t * >( block );
+
+    deallocations.fetch_add( 1, std::memory_order_relaxed );
+    live_bytes.fetch_sub( size, std::memory_order_relaxed );
+
+    thread_deallocations++;
+    thread_live_bytes -= size;
+
+    std::free( block );
+}
+
+}
+
+
+AllocationStats allocation_stats() {
+    AllocationStats stats;
+    stats.allocations = allocations.load( std::memory_order_relaxed );
+    stats.deallocations = deallocations.load( std::memory_order_relaxed );
+    stats.allocated_bytes = allocated_bytes.load( std::memory_order_relaxed );
+    stats.live_bytes = live_bytes.load( std::memory_order_relaxed );
+    stats.peak_live_bytes = peak_live_bytes.load( std::memory_order_relaxed );
+    return stats;
+}
+
+void reset_peak_allocation() {
+    peak_live_bytes.store( live_bytes.load( std::memory_order_relaxed ), std::memory_order_relaxed );
+}
+
+AllocationStats thread_allocation_stats() {
+    AllocationStats stats;
+    stats.allocations = thread_allocations;
+    stats.deallocations = thread_deallocations;
+    stats.allocated_bytes = thread_allocated_bytes;
+    stats.live_bytes = static_cast< size_t >( std::max( thread_live_bytes, 0LL ) );
+    stats.peak_live_bytes = static_cast< size_t >( thread_peak_live_bytes );
+    return stats;
+}
+
+void reset_thread_live_bytes() {
+    thread_live_bytes = 0;
+    thread_peak_live_bytes = 0;
+}
+
+
+void *operator new( size_t size ) {
+    if ( void *ptr = counted_allocate( size ) ) { return ptr; }
+    throw std::bad_alloc();
+}
+
+void *operator new[]( size_t size ) {
+    if ( void *ptr = counted_allocate( size ) ) { return ptr; }
+    throw std::bad_alloc();
+}
+
+void *operator new( size_t size, const std::nothrow_t & ) noexcept {
+    return counted_allocate( size );
+}
+
+void *operator new[]( size_t size, const std::nothrow_t & ) noexcept {
+    return counted_allocate( size );
+}
+
+void operator delete( void *ptr ) noexcept {
+    counted_free( ptr );
+}
+
+void operator delete[]( void *ptr ) noexcept {
+    counted_free( ptr );
+}
+
+void operator delete( void *ptr, size_t ) noexcept {
+    counted_free( ptr );
+}
+
+void operator delete[]( void *ptr, size_t ) noexcept {
+    counted_free( ptr );
+}
+
+void operator delete( void *ptr, const std::nothrow_t & ) noexcept {
+    counted_free( ptr );
+}
+
+void operator delete[]( void *ptr, const std::nothrow_t & ) noexcept {
+    counted_free( ptr );
+}
@@ -0,0 +1,95 @@
+#include "models/generator.hpp"
+#include "scaling_evaluation.hpp"
+
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+/*
+ * generator of synthetic MDPs, see include/models/generator.hpp
+ *
+ * usage: mdp-generator [ options ] --out prefix
+ *          writes prefix.tra and prefix1.trew, prefix2.trew, ...
+ *
+ *        mdp-generator [ options ] --scaling 1000,10000,100000
+ *          solves models of the given sizes by every engine, see
+ *          include/scaling_evaluation.hpp
+ *
+ * options: --states n --actions n --branching n --window n --back-edges p
+ *          --objectives n --spread r --conflict c --seed s
+ *          --discount d --precision p --max-seconds t ( only for --scaling )
+ */
+
+std::vector< size_t > parse_sizes( const std::string &list ) {
+    std::vector< size_t > sizes;
+    std::istringstream in( list );
+    std::string item;
+
+    while ( std::getline( in, item, ',' ) ) {
+        sizes.push_back( std::stoul( item ) );
+    }
+
+    return sizes;
+}
+
+
+int main( int argc, char **argv ) {
+
+    GeneratorSettings settings;
+
+    ExplorationSettings< double > config;
+    config.trace = false;
+    config.max_depth = 0;
+    config.max_episodes = 0;
+    config.max_seconds = 300;
+    config.precision = 0.1;
+    config.discount_param = 0.95;
+    config.depth_constant = 50;
+    config.directions = { OptimizationDirection::MAXIMIZE, OptimizationDirection::MAXIMIZE };
+
+    std::string prefix;
+    std::vector< size_t > sizes;
+
+    for ( int i = 1; i < argc; i++ ) {
+        std::string arg = argv[i];
+
+        if ( i + 1 >= argc ) {
+            std::cerr << "missing value of " << arg << "\n";
+            return 1;
+        }
+
+        std::string value = argv[ ++i ];
+
+        if ( arg == "--states" )            { settings.states = std::stoul( value ); }
+        else if ( arg == "--actions" )      { settings.actions = std::stoul( value ); }
+        else if ( arg == "--branching" )    { settings.branching = std::stoul( value ); }
+        else if ( arg == "--window" )       { settings.forward_window = std::stoul( value ); }
+        else if ( arg == "--back-edges" )   { settings.back_edge_prob = std::stod( value ); }
+        else if ( arg == "--objectives" )   { settings.objectives = std::stoul( value ); }
+        else if ( arg == "--spread" )       { settings.reward_spread = std::stod( value ); }
+        else if ( arg == "--conflict" )     { settings.conflict = std::stod( value ); }
+        else if ( arg == "--seed" )         { settings.seed = std::stoul( value ); }
+        else if ( arg == "--discount" )     { config.discount_param = std::stod( value ); }
+        else if ( arg == "--precision" )    { config.precision = std::stod( value ); }
+        else if ( arg == "--max-seconds" )  { config.max_seconds = std::stod( value ); }
+        else if ( arg == "--out" )          { prefix = value; }
+        else if ( arg == "--scaling" )      { sizes = parse_sizes( value ); }
+        else {
+            std::cerr << "unknown argument " << arg << "\n";
+            return 1;
+        }
+    }
+
+    if ( !sizes.empty() ) {
+        eval_scaling( sizes, settings, config );
+        return 0;
+    }
+
+    if ( prefix.empty() ) {
+        std::cerr << "either --out or --scaling has to be given\n";
+        return 1;
+    }
+
+    write_prism( settings, prefix + ".tra", prefix );
+}
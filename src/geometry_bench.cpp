@@ -0,0 +1,223 @@
+#include "geometry/polygon.hpp"
+#include "utils/allocation_counter.hpp"
+#include "utils/prng.hpp"
+
+#include <chrono>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <string>
+#include <vector>
+
+/*
+ * microbenchmarks of the geometry kernels used in the bound updates, each
+ * kernel is run on synthetic convex chains and reported as one csv row
+ *
+ *  kernel;dimension;vertices;curves;repeat;batch;ns per op;allocs per op
+ *
+ * usage: geometry-bench [ --vertices n ] [ --curves k ] [ --dimension d ]
+ *                       [ --repeat r ] [ --batch b ] [ --seed s ] [ --out file ]
+ *
+ * each of the repeat samples times a batch of b calls at once, so that the
+ * overhead of the clock does not distort fast kernels
+ *
+ * without --out the rows are written to stdout
+ *
+ * the allocations are counted by src/allocation_counter.cpp, which is always
+ * linked to this executable, only the allocations inside the timed calls are
+ * attributed to the kernels
+ */
+
+
+struct BenchSettings {
+    size_t vertices = 32;
+    size_t curves = 4;
+    size_t dimension = 2;
+    size_t repeat = 100;
+    size_t batch = 100;
+    unsigned seed = 1;
+    std::string filename;
+};
+
+struct BenchResult {
+    double ns_per_op;
+    double allocs_per_op;
+};
+
+
+/* takes repeat samples, each runs setup( i ) for all i < batch ( untimed )
+ * and then kernel( i ) for all i < batch in one timed region, the setup is
+ * used to prepare the inputs that the i-th call of the kernel consumes */
+BenchResult measure( size_t repeat, size_t batch,
+                     const std::function< void( size_t ) > &setup,
+                     const std::function< void( size_t ) > &kernel ) {
+
+    std::chrono::duration< double, std::nano > total( 0 );
+    size_t allocations = 0;
+
+    for ( size_t sample = 0; sample < repeat; sample++ ) {
+        for ( size_t i = 0; i < batch; i++ ) {
+            setup( i );
+        }
+
+        size_t allocs_before = allocation_stats().allocations;
+        auto start = std::chrono::steady_clock::now();
+
+        for ( size_t i = 0; i < batch; i++ ) {
+            kernel( i );
+        }
+
+        auto finish = std::chrono::steady_clock::now();
+        allocations += allocation_stats().allocations - allocs_before;
+        total += finish - start;
+    }
+
+    double calls = static_cast< double >( repeat * batch );
+    return BenchResult{ total.count() / calls,
+                        static_cast< double >( allocations ) / calls };
+}
+
+
+/* random convex chain with vertices sorted by descending x, points on a
+ * quarter of an ellipse with random axes, 1D chains are a single point */
+Polygon< double > random_chain( PRNG &gen, size_t vertices, size_t dimension ) {
+
+    if ( dimension == 1 ) {
+        return Polygon< double >( std::vector< Point< double > >{ { gen.rand_float() * 100 } } );
+    }
+
+    double width = 1 + gen.rand_float() * 100, height = 1 + gen.rand_float() * 100;
+
+    std::vector< double > angles;
+    for ( size_t i = 0; i < vertices; i++ ) {
+        angles.push_back( gen.rand_float() * M_PI / 2 );
+    }
+    std::sort( angles.begin(), angles.end() );
+
+    std::vector< Point< double > > points;
+    for ( double angle : angles ) {
+        points.push_back( { width * std::cos( angle ), height * std::sin( angle ) } );
+    }
+
+    return Polygon< double >( upper_right_hull( points, 0 ) );
+}
+
+
+bool parse_args( int argc, char **argv, BenchSettings &settings ) {
+    for ( int i = 1; i < argc; i++ ) {
+        std::string arg = argv[i];
+
+        if ( i + 1 >= argc ) {
+            std::cerr << "missing value of " << arg << "\n";
+            return false;
+        }
+
+        std::string value = argv[ ++i ];
+
+        if ( arg == "--vertices" )       { settings.vertices = std::stoul( value ); }
+        else if ( arg == "--curves" )    { settings.curves = std::stoul( value ); }
+        else if ( arg == "--dimension" ) { settings.dimension = std::stoul( value ); }
+        else if ( arg == "--repeat" )    { settings.repeat = std::stoul( value ); }
+        else if ( arg == "--batch" )     { settings.batch = std::stoul( value ); }
+        else if ( arg == "--seed" )      { settings.seed = std::stoul( value ); }
+        else if ( arg == "--out" )       { settings.filename = value; }
+        else {
+            std::cerr << "unknown argument " << arg << "\n";
+            return false;
+        }
+    }
+
+    if ( ( settings.dimension < 1 ) || ( settings.dimension > 2 ) ) {
+        std::cerr << "only 1D / 2D curves are supported\n";
+        return false;
+    }
+
+    if ( ( settings.vertices == 0 ) || ( settings.curves == 0 ) || ( settings.repeat == 0 ) || ( settings.batch == 0 ) ) {
+        std::cerr << "vertices, curves, repeat and batch must be positive\n";
+        return false;
+    }
+
+    return true;
+}
+
+
+int main( int argc, char **argv ) {
+
+    BenchSettings settings;
+    if ( !parse_args( argc, argv, settings ) ) { return 1; }
+
+    PRNG gen( settings.seed );
+
+    std::vector< Polygon< double > > curves;
+    for ( size_t i = 0; i < settings.curves; i++ ) {
+        curves.push_back( random_chain( gen, settings.vertices, settings.dimension ) );
+    }
+
+    std::vector< Polygon< double > * > curve_ptrs;
+    for ( auto &curve : curves ) {
+        curve_ptrs.push_back( &curve );
+    }
+
+    std::vector< double > probs( settings.curves, 1.0 / settings.curves );
+
+    std::vector< Point< double > > all_points;
+    for ( const auto &curve : curves ) {
+        const auto &vertices = curve.get_vertices();
+        all_points.insert( all_points.end(), vertices.begin(), vertices.end() );
+    }
+
+    // reference point below all curves, for closures and hypervolumes
+    Point< double > ref_point( settings.dimension, -1 );
+
+    // lower curve with facets initialized, upper curve dominating it
+    Polygon< double > lower( curves[0] ), upper( curves[0] );
+    upper.multiply_scalar( 1.1 );
+    lower.init_facets();
+    lower.downward_closure( ref_point );
+
+    // keeps results alive so that the kernels are not optimized out
+    double sink = 0;
+
+    // inputs consumed by upper_right_hull, one per call of a batch
+    std::vector< std::vector< Point< double > > > points( settings.batch );
+
+    auto no_setup = []( size_t ){  };
+    size_t repeat = settings.repeat, batch = settings.batch;
+
+    std::vector< std::pair< std::string, BenchResult > > results;
+
+    results.emplace_back( "weighted_minkowski_sum", measure( repeat, batch, no_setup, [ & ]( size_t ){
+        sink += weighted_minkowski_sum( curve_ptrs, probs ).size();
+    }));
+
+    results.emplace_back( "upper_right_hull", measure( repeat, batch, [ & ]( size_t i ){ points[i] = all_points; }, [ & ]( size_t i ){
+        sink += upper_right_hull( points[i], 0 ).size();
+    }));
+
+    results.emplace_back( "hull_union", measure( repeat, batch, no_setup, [ & ]( size_t ){
+        sink += hull_union( curve_ptrs, 0 ).size();
+    }));
+
+    if ( settings.dimension == 2 ) {
+        results.emplace_back( "hausdorff_distance", measure( repeat, batch, no_setup, [ & ]( size_t ){
+            sink += lower.hausdorff_distance( upper ).first;
+        }));
+    }
+
+    results.emplace_back( "hypervolume", measure( repeat, batch, no_setup, [ & ]( size_t ){
+        sink += upper.hypervolume( ref_point );
+    }));
+
+    std::ofstream file;
+    if ( !settings.filename.empty() ) { file.open( settings.filename ); }
+    std::ostream &out = settings.filename.empty() ? std::cout : file;
+
+    out << "kernel;dimension;vertices;curves;repeat;batch;ns per op;allocs per op\n";
+    for ( const auto &[ kernel, res ] : results ) {
+        out << kernel << ";" << settings.dimension << ";" << settings.vertices << ";" << settings.curves << ";";
+        out << settings.repeat << ";" << settings.batch << ";" << res.ns_per_op << ";" << res.allocs_per_op << "\n";
+    }
+
+    // never true, forces the computation of sink
+    if ( sink < 0 ) { std::cerr << sink << "\n"; }
+}
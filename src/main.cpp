@@ -6,29 +6,72 @@
 #include "solvers/brtdp.hpp"
 #include "solvers/chvi.hpp"
 #include "solvers/config.hpp"
+#include "solvers/weighted_sum.hpp"
 
 #include "utils/prng.hpp"
 
 #include "evaluation.hpp"
 #include "parser_evaluation.hpp"
+#include "scaling_evaluation.hpp"
+#include "simulation_evaluation.hpp"
+#include "validation_evaluation.hpp"
 
 #include "parser.hpp"
 #include <iostream>
 
 
-int main() {
+int main( int argc, char **argv ) {
+
+    // scaling over all shipped PRISM model sizes instead of the benchmarks
+    if ( ( argc > 1 ) && ( std::string( argv[1] ) == "--prism-scaling" ) ) {
+        eval_prism_scaling();
+        return 0;
+    }
+
+    // throughput of the batched simulation of the benchmarks
+    if ( ( argc > 1 ) && ( std::string( argv[1] ) == "--simulate" ) ) {
+        eval_simulation();
+        return 0;
+    }
+
+    // monte carlo validation of the lower curves found by BRTDP
+    if ( ( argc > 1 ) && ( std::string( argv[1] ) == "--validate" ) ) {
+        ValidationSettings settings;
+        settings.seed = 1;
+        eval_validation( settings );
+        return 0;
+    }
 
     std::ofstream out( "../out/results.csv" );
     std::ofstream expl( "../out/explored.csv" );
+    std::ofstream ws( "../out/weighted_sum.csv" );
     out << "Benchmark name;num of states;time mean brtdp;time std brtdp;";
-    out << "updates brtdp mean;updates brtdp std;time chvi; updates chvi\n";
+    out << "updates brtdp mean;updates brtdp std;time chvi;time std chvi;updates chvi;threads\n";
     expl << "Benchmark name; num of states; mean; std\n";
+    ws << "Benchmark name;time;backups;converged;distance from chvi\n";
     out.close();
     expl.close();
+    ws.close();
+
+    if constexpr ( profiling_enabled ) {
+        std::ofstream profile( "../out/profile.csv" );
+        profile << "Benchmark name;solver;phase;time mean;calls mean\n";
+    }
+
+    /* all runs of both heuristics are scheduled at once, on a single thread
+     * by default so that the times are not affected by contention,
+     * --threads N runs them in parallel ( 0 -> one thread per core ) */
+    size_t threads = 1;
+    if ( ( argc > 2 ) && ( std::string( argv[1] ) == "--threads" ) ) {
+        threads = std::stoul( argv[2] );
+    }
+
+    BenchmarkHarness harness( threads );
+    std::cout << "Running benchmarks on " << harness.num_threads() << " threads.\n";
 
     for ( auto heuristic : { ActionSelectionHeuristic::Pareto, ActionSelectionHeuristic::Hausdorff } ) {
-        eval_benchmarks( 50, heuristic );
-        out << "\n";
-        expl << "\n";
+        eval_benchmarks( 50, heuristic, harness );
     }
+
+    harness.collect();
 }
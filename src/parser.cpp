@@ -407,15 +407,30 @@ MDP< double > PrismParser::parse_model( const std::string &transition_file,
                                         size_t initial_state ) {
     //new model -> new rewards, transitions get reset in parse transition file
     reward_info.clear();
+    stats = ParseStats();
+    reset_peak_rss();
+
     try{
 
         std::cout << "Parsing " << transition_file << std::endl;
         parse_transition_file( transition_file );
+        stats.transitions_peak_rss = peak_rss_kb();
+
         for ( const auto &str : reward_files ){
             std::cout << "Parsing " << str << std::endl;
             parse_reward_file( str );
         }
-        return build_model( initial_state );
+        stats.rewards_peak_rss = peak_rss_kb();
+        stats.triplet_bytes = memory_bytes();
+
+        MDP< double > model = build_model( initial_state );
+        stats.build_peak_rss = peak_rss_kb();
+        stats.model_bytes = model.memory_bytes();
+
+        std::cout << "Triplets: " << stats.triplet_bytes / 1024 << " kB, model: "
+                  << stats.model_bytes / 1024 << " kB, peak rss: " << stats.build_peak_rss << " kB.\n";
+
+        return model;
     }
 
     // output error message and rethrow ( terminate )
@@ -426,6 +441,21 @@ MDP< double > PrismParser::parse_model( const std::string &transition_file,
 }
 
 
+size_t PrismParser::memory_bytes() const {
+    size_t bytes = 0;
+
+    for ( const auto &[ _, triplets ] : transition_info ) {
+        bytes += triplets.memory_bytes();
+    }
+
+    for ( const auto &triplets : reward_info ) {
+        bytes += triplets.memory_bytes();
+    }
+
+    return bytes;
+}
+
+
 bool PrismParser::ignore_line( const std::string &line) {
 
     return line.empty() || ( line[0] == '#' ) ;